@@ -8,7 +8,7 @@
 
 #include "SDLPackage.h"
 
-#define nullOrValue(sth) (isNothingness(sth) ? NULL : (sth).object->value)
+#define nullOrValue(sth) (isNothingness(sth) ? NULL : objectValue((sth).object))
 
 #define windowName 0x1F5BC //🖼
 #define rendererName 0x1F58C //🖌
@@ -48,13 +48,13 @@ static Something appPollEvent(Thread *thread){
             case SDL_KEYDOWN:
             case SDL_KEYUP: {
                 Object *keyboard = newObject(keyboardEvent);
-                *(SDL_KeyboardEvent *)keyboard->value = e.key;
+                *(SDL_KeyboardEvent *)objectValue(keyboard) = e.key;
                 return somethingObject(keyboard);
             }
             case SDL_MOUSEBUTTONDOWN:
             case SDL_MOUSEBUTTONUP: {
                 Object *keyboard = newObject(mouseButtonEvent);
-                *(SDL_KeyboardEvent *)keyboard->value = e.key;
+                *(SDL_KeyboardEvent *)objectValue(keyboard) = e.key;
                 return somethingObject(keyboard);
             }
             default:
@@ -65,12 +65,12 @@ static Something appPollEvent(Thread *thread){
 }
 
 static void windowInit(Thread *thread){
-    char *str = stringToChar(stackGetVariable(0, thread).object->value);
+    char *str = stringToChar(objectValue(stackGetVariable(0, thread).object));
     int x = (int)unwrapInteger(stackGetVariable(1, thread));
     int y = (int)unwrapInteger(stackGetVariable(2, thread));
     int w = (int)unwrapInteger(stackGetVariable(3, thread));
     int h = (int)unwrapInteger(stackGetVariable(4, thread));
-    *(SDL_Window **)stackGetThis(thread)->value = SDL_CreateWindow(str, x, y, w, h, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+    *(SDL_Window **)objectValue(stackGetThis(thread)) = SDL_CreateWindow(str, x, y, w, h, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
     free(str);
 }
 
@@ -79,8 +79,8 @@ static void windowDeinit(void *w){
 }
 
 static void rendererInit(Thread *thread){
-    SDL_Window *window = *(SDL_Window **)stackGetVariable(0, thread).object->value;
-    *(SDL_Renderer **)stackGetThis(thread)->value = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Window *window = *(SDL_Window **)objectValue(stackGetVariable(0, thread).object);
+    *(SDL_Renderer **)objectValue(stackGetThis(thread)) = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
 }
 
 static void rendererDeinit(void *r){
@@ -88,7 +88,7 @@ static void rendererDeinit(void *r){
 }
 
 static Something rendererDrawLine(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
     int x1 = (int)unwrapInteger(stackGetVariable(0, thread));
     int y1 = (int)unwrapInteger(stackGetVariable(1, thread));
     int x2 = (int)unwrapInteger(stackGetVariable(2, thread));
@@ -99,19 +99,19 @@ static Something rendererDrawLine(Thread *thread){
 }
 
 static Something rendererFillRect(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
-    SDL_RenderFillRect(renderer, (SDL_Rect *)stackGetVariable(0, thread).object->value);
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
+    SDL_RenderFillRect(renderer, (SDL_Rect *)objectValue(stackGetVariable(0, thread).object));
     return NOTHINGNESS;
 }
 
 static Something rendererDrawRect(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
-    SDL_RenderDrawRect(renderer, (SDL_Rect *)stackGetVariable(0, thread).object->value);
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
+    SDL_RenderDrawRect(renderer, (SDL_Rect *)objectValue(stackGetVariable(0, thread).object));
     return NOTHINGNESS;
 }
 
 static Something rendererSetDrawColor(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
     int r = (uint8_t)unwrapInteger(stackGetVariable(0, thread));
     int g = (uint8_t)unwrapInteger(stackGetVariable(1, thread));
     int b = (uint8_t)unwrapInteger(stackGetVariable(2, thread));
@@ -121,19 +121,19 @@ static Something rendererSetDrawColor(Thread *thread){
 }
 
 static Something rendererPresent(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
     SDL_RenderPresent(renderer);
     return NOTHINGNESS;
 }
 
 static Something rendererClear(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
     SDL_RenderClear(renderer);
     return NOTHINGNESS;
 }
 
 static void rectInit(Thread *thread){
-    SDL_Rect *rect = stackGetThis(thread)->value;
+    SDL_Rect *rect = objectValue(stackGetThis(thread));
     rect->x = (int)unwrapInteger(stackGetVariable(0, thread));
     rect->y = (int)unwrapInteger(stackGetVariable(1, thread));
     rect->w = (int)unwrapInteger(stackGetVariable(2, thread));
@@ -141,30 +141,30 @@ static void rectInit(Thread *thread){
 }
 
 static Something rendererCopyTexture(Thread *thread){
-    SDL_Renderer *renderer = *(SDL_Renderer **)stackGetThis(thread)->value;
+    SDL_Renderer *renderer = *(SDL_Renderer **)objectValue(stackGetThis(thread));
     Something source = stackGetVariable(1, thread);
     Something destination = stackGetVariable(2, thread);
-    SDL_RenderCopy(renderer, *(SDL_Texture **)stackGetVariable(0, thread).object->value, nullOrValue(source), nullOrValue(destination));
+    SDL_RenderCopy(renderer, *(SDL_Texture **)objectValue(stackGetVariable(0, thread).object), nullOrValue(source), nullOrValue(destination));
     return NOTHINGNESS;
 }
 
 static void textureInitFromSurface(Thread *thread){
-    SDL_Renderer **renderer = stackGetVariable(0, thread).object->value;
-    SDL_Surface **surface = stackGetVariable(1, thread).object->value;
-    *(SDL_Texture **)stackGetThis(thread)->value = SDL_CreateTextureFromSurface(*renderer, *surface);
+    SDL_Renderer **renderer = objectValue(stackGetVariable(0, thread).object);
+    SDL_Surface **surface = objectValue(stackGetVariable(1, thread).object);
+    *(SDL_Texture **)objectValue(stackGetThis(thread)) = SDL_CreateTextureFromSurface(*renderer, *surface);
 }
 
 
 static void surfaceInitFromBMP(Thread *thread){
-    char *path = stringToChar(stackGetVariable(0, thread).object->value);
+    char *path = stringToChar(objectValue(stackGetVariable(0, thread).object));
     SDL_Surface *surface = SDL_LoadBMP(path);
     
     if (surface == NULL) {
-        stackGetThis(thread)->value = NULL;
+        failInitializer(thread);
         return;
     }
     
-    *(SDL_Surface**)stackGetThis(thread)->value = surface;
+    *(SDL_Surface**)objectValue(stackGetThis(thread)) = surface;
     free(path);
 }
 
@@ -176,27 +176,27 @@ static void surfaceDeinit(void *r){
 //MARK: Events
 
 static Something keyboardEventDown(Thread *thread){
-    SDL_KeyboardEvent *e = stackGetThis(thread)->value;
+    SDL_KeyboardEvent *e = objectValue(stackGetThis(thread));
     return e->type == SDL_KEYDOWN ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
 static Something keyboardEventSymbol(Thread *thread){
-    SDL_KeyboardEvent *e = stackGetThis(thread)->value;
+    SDL_KeyboardEvent *e = objectValue(stackGetThis(thread));
     return keyCodeToChar(e->keysym.sym);
 }
 
 static Something mouseButtonEventGetX(Thread *thread){
-    SDL_MouseButtonEvent *e = stackGetThis(thread)->value;
+    SDL_MouseButtonEvent *e = objectValue(stackGetThis(thread));
     return somethingInteger(e->x);
 }
 
 static Something mouseButtonEventGetY(Thread *thread){
-    SDL_MouseButtonEvent *e = stackGetThis(thread)->value;
+    SDL_MouseButtonEvent *e = objectValue(stackGetThis(thread));
     return somethingInteger(e->y);
 }
 
 static Something mouseButtonEventDown(Thread *thread){
-    SDL_MouseButtonEvent *e = stackGetThis(thread)->value;
+    SDL_MouseButtonEvent *e = objectValue(stackGetThis(thread));
     return e->type == SDL_MOUSEBUTTONDOWN ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
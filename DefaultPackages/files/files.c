@@ -26,15 +26,15 @@ if((failureCondition))\
 
 //MARK: files
 Something filesMkdir(Thread *thread){
-    int state = mkdir(stringToChar(stackGetVariable(0, thread).object->value), 0755);
+    int state = mkdir(stringToChar(objectValue(stackGetVariable(0, thread).object)), 0755);
     
     handleNEP(state != 0);
     return NOTHINGNESS;
 }
 
 Something filesSymlink(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
-    int state = symlink(s, stringToChar(stackGetVariable(1, thread).object->value));
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
+    int state = symlink(s, stringToChar(objectValue(stackGetVariable(1, thread).object)));
     free(s);
     
     handleNEP(state != 0);
@@ -42,35 +42,35 @@ Something filesSymlink(Thread *thread){
 }
 
 Something filesFileExists(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     Something x = (access(s, F_OK) == 0) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
     free(s);
     return x;
 }
 
 Something filesIsReadable(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     Something x = (access(s, R_OK) == 0) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
     free(s);
     return x;
 }
 
 Something filesIsWriteable(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     Something x = (access(s, W_OK) == 0)  ? EMOJICODE_TRUE : EMOJICODE_FALSE;
     free(s);
     return x;
 }
 
 Something filesIsExecuteable(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     Something x = (access(s, X_OK) == 0)  ? EMOJICODE_TRUE : EMOJICODE_FALSE;
     free(s);
     return x;
 }
 
 Something filesRemove(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     int state = remove(s);
     free(s);
     
@@ -79,7 +79,7 @@ Something filesRemove(Thread *thread){
 }
 
 Something filesRmdir(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     int state = rmdir(s);
     free(s);
     
@@ -104,7 +104,7 @@ int filesRecursiveRmdirHelper(const char *fpath, const struct stat *sb, int type
 }
 
 Something filesRecursiveRmdir(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     
     int state = nftw(s, filesRecursiveRmdirHelper, 64, FTW_DEPTH | FTW_PHYS);
     handleNEP(state != 0);
@@ -117,7 +117,7 @@ Something filesRecursiveRmdir(Thread *thread){
 }
 
 Something filesSize(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     
     FILE *file = fopen(s, "r");
     free(s);
@@ -141,14 +141,15 @@ Something filesSize(Thread *thread){
 //Shortcuts
 
 Something fileStringPut(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *file = fopen(s, "w");
     free(s);
     
     handleNEP(file == NULL);
     
-    s = stringToChar(stackGetVariable(1, thread).object->value);
-    fwrite(s, 1, strlen(s), file);
+    size_t length;
+    s = stringToUTF8(objectValue(stackGetVariable(1, thread).object), &length);
+    fwrite(s, 1, length, file);
     free(s);
     
     handleNEP(ferror(file));
@@ -158,13 +159,13 @@ Something fileStringPut(Thread *thread){
 }
 
 Something fileDataPut(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *file = fopen(s, "wb");
     free(s);
     
     handleNEP(file == NULL);
     
-    Data *d = stackGetVariable(1, thread).object->value;
+    Data *d = objectValue(stackGetVariable(1, thread).object);
     
     fwrite(d->bytes, 1, d->length, file);
     
@@ -177,7 +178,7 @@ Something fileDataPut(Thread *thread){
 }
 
 Something fileStringGet(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *file = fopen(s, "r");
     free(s);
     
@@ -192,8 +193,9 @@ Something fileStringGet(Thread *thread){
     fseek(file, 0, SEEK_SET);
     
     char *stringBuffer = malloc(length + 1);
+    size_t read = 0;
     if (stringBuffer){
-        fread(stringBuffer, 1, length, file);
+        read = fread(stringBuffer, 1, length, file);
         if(ferror(file)){
             fclose(file);
             return NOTHINGNESS;
@@ -204,16 +206,15 @@ Something fileStringGet(Thread *thread){
         return NOTHINGNESS;
     }
     fclose(file);
-    stringBuffer[length] = 0;
         
-    Object *string = stringFromChar(stringBuffer);
+    Object *string = stringFromUTF8(stringBuffer, read);
     free(stringBuffer);
     
     return somethingObject(string);
 }
 
 Something fileDataGet(Thread *thread){
-    char *s = stringToChar(stackGetVariable(0, thread).object->value);
+    char *s = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *file = fopen(s, "r");
     free(s);
     
@@ -242,14 +243,14 @@ Something fileDataGet(Thread *thread){
     fclose(file);
     
     Object *obj = newObject(CL_DATA);
-    Data *data = obj->value;
+    Data *data = objectValue(obj);
     data->bytes = stringBuffer;
     data->length = length;
     
     return somethingObject(obj);
 }
 
-#define file(obj) (*((FILE**)(obj)->value))
+#define file(obj) (*((FILE**)objectValue(obj)))
 
 Something fileStdinGet(Thread *thread){
     Object *obj = newObject(stackGetThisClass(thread));
@@ -272,32 +273,32 @@ Something fileStderrGet(Thread *thread){
 //Constructors
 
 void fileForWriting(Thread *thread){
-    char *p = stringToChar(stackGetVariable(0, thread).object->value);
+    char *p = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *f = fopen(p, "wb");
     if (f){
         file(stackGetThis(thread)) = f;
     }
     else {
-        stackGetThis(thread)->value = NULL;
+        failInitializer(thread);
     }
     free(p);
 }
 
 void fileForReading(Thread *thread){
-    char *p = stringToChar(stackGetVariable(0, thread).object->value);
+    char *p = stringToChar(objectValue(stackGetVariable(0, thread).object));
     FILE *f = fopen(p, "rb");
     if (f){
         file(stackGetThis(thread)) = f;
     }
     else {
-        stackGetThis(thread)->value = NULL;
+        failInitializer(thread);
     }
     free(p);
 }
 
 Something fileWriteData(Thread *thread){
     FILE *f = file(stackGetThis(thread));
-    Data *d = stackGetVariable(0, thread).object->value;
+    Data *d = objectValue(stackGetVariable(0, thread).object);
     
     fwrite(d->bytes, 1, d->length, f);
     fflush(f);
@@ -319,7 +320,7 @@ Something fileReadData(Thread *thread){
     }
     
     Object *obj = newObject(CL_DATA);
-    Data *data = obj->value;
+    Data *data = objectValue(obj);
     data->bytes = bytes;
     data->length = n;
     
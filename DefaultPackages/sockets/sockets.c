@@ -0,0 +1,708 @@
+//
+//  sockets.c
+//  DefaultPackages
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#define _GNU_SOURCE
+#include "EmojicodeAPI.h"
+#include "EmojicodeString.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * All sockets are non-blocking and registered with the epoll instance of the 🌀 they were created for. The loop
+ * keeps a registration, indexed by file descriptor, for every open socket. The registrations keep the sockets and
+ * their callbacks alive until the socket is closed. Interest in EPOLLOUT is only registered while data is waiting
+ * to be written, interest in EPOLLIN only if there is a callback, as the epoll instance is level-triggered.
+ */
+
+PackageVersion getVersion(){
+    return (PackageVersion){0, 1};
+}
+
+/** The maximal number of bytes read from a connection per event. */
+#define readSize (64 * 1024)
+/** The maximal number of connections accepted per event, so that a busy server cannot starve the others. */
+#define acceptsPerEvent 64
+#define eventsPerWait 256
+
+static Class *connectionClass;
+
+typedef struct {
+    /** The 📡 or 📞 or @c NULL if there is no open socket with this file descriptor. */
+    Object *socket;
+    /** The accept callback of a 📡 or the read callback of a 📞. */
+    Object *callback;
+    bool listening;
+} Registration;
+
+typedef struct {
+    int epoll;
+    /** The registrations indexed by file descriptor. */
+    Registration *registrations;
+    int registrationsCapacity;
+    /** The number of open sockets. */
+    size_t socketCount;
+    bool stopped;
+} EventLoop;
+
+typedef struct {
+    int fd;
+    Object *loop;
+} Server;
+
+typedef struct {
+    int fd;
+    Object *loop;
+    /** The events the epoll instance reports for this connection. */
+    uint32_t interest;
+    bool connecting;
+    /** Whether the connection shall be closed as soon as all pending bytes were written. */
+    bool closeRequested;
+    /** Bytes that could not be written yet. */
+    char *pending;
+    size_t pendingOffset;
+    size_t pendingLength;
+    size_t pendingCapacity;
+} Connection;
+
+#define eventLoop(obj) ((EventLoop *)objectValue(obj))
+#define server(obj) ((Server *)objectValue(obj))
+#define connection(obj) ((Connection *)objectValue(obj))
+
+//MARK: Event Loop
+
+/** Raises the limit of open files so that a loop can serve thousands of connections. */
+static void raiseFileLimit(){
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static void loopInit(Thread *thread){
+    EventLoop *loop = eventLoop(stackGetThis(thread));
+    loop->epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll < 0) {
+        failInitializer(thread);
+        return;
+    }
+    raiseFileLimit();
+}
+
+/** Registers the socket, which must not be registered with the epoll instance yet, with no interest. */
+static bool loopRegister(Object *loopObject, int fd, Object *socket, bool listening){
+    EventLoop *loop = eventLoop(loopObject);
+
+    struct epoll_event event = { .events = 0, .data.fd = fd };
+    if (epoll_ctl(loop->epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+        return false;
+    }
+
+    if (fd >= loop->registrationsCapacity) {
+        int capacity = loop->registrationsCapacity ? loop->registrationsCapacity : 64;
+        while (capacity <= fd) {
+            capacity *= 2;
+        }
+        Registration *registrations = realloc(loop->registrations, sizeof(Registration) * capacity);
+        if (!registrations) {
+            epoll_ctl(loop->epoll, EPOLL_CTL_DEL, fd, NULL);
+            return false;
+        }
+        memset(registrations + loop->registrationsCapacity, 0,
+               sizeof(Registration) * (capacity - loop->registrationsCapacity));
+        loop->registrations = registrations;
+        loop->registrationsCapacity = capacity;
+    }
+
+    loop->registrations[fd] = (Registration){ .socket = socket, .callback = NULL, .listening = listening };
+    loop->socketCount++;
+    writeBarrier(loopObject, somethingObject(socket));
+    return true;
+}
+
+/** Closes the file descriptor and releases the registration. */
+static void loopUnregister(Object *loopObject, int fd){
+    EventLoop *loop = eventLoop(loopObject);
+    loop->registrations[fd] = (Registration){ .socket = NULL, .callback = NULL };
+    loop->socketCount--;
+    close(fd);
+}
+
+static void loopSetCallback(Object *loopObject, int fd, Object *callback){
+    eventLoop(loopObject)->registrations[fd].callback = callback;
+    writeBarrier(loopObject, somethingObject(callback));
+}
+
+static void loopSetInterest(Object *loopObject, int fd, uint32_t events){
+    struct epoll_event event = { .events = events, .data.fd = fd };
+    epoll_ctl(eventLoop(loopObject)->epoll, EPOLL_CTL_MOD, fd, &event);
+}
+
+static void loopMark(Object *self){
+    EventLoop *loop = objectValue(self);
+    for (int fd = 0; fd < loop->registrationsCapacity; fd++) {
+        Registration *registration = loop->registrations + fd;
+        if (registration->socket) {
+            mark(&registration->socket);
+        }
+        if (registration->callback) {
+            mark(&registration->callback);
+        }
+    }
+}
+
+static void loopDeinit(void *value){
+    EventLoop *loop = value;
+    if (loop->epoll >= 0) {
+        close(loop->epoll);
+    }
+    free(loop->registrations);
+}
+
+//MARK: Connections
+
+/** Updates the interest of the connection in its events after its callback or its pending bytes changed. */
+static void connectionUpdateInterest(Object *connectionObject){
+    Connection *c = connection(connectionObject);
+    uint32_t interest = 0;
+    if (eventLoop(c->loop)->registrations[c->fd].callback) {
+        interest |= EPOLLIN;
+    }
+    if (c->connecting || c->pendingLength > c->pendingOffset) {
+        interest |= EPOLLOUT;
+    }
+    if (interest != c->interest) {
+        c->interest = interest;
+        loopSetInterest(c->loop, c->fd, interest);
+    }
+}
+
+static void connectionClose(Object *connectionObject){
+    Connection *c = connection(connectionObject);
+    if (c->fd < 0) {
+        return;
+    }
+    loopUnregister(c->loop, c->fd);
+    c->fd = -1;
+    free(c->pending);
+    c->pending = NULL;
+    c->pendingOffset = c->pendingLength = c->pendingCapacity = 0;
+}
+
+/** Writes as many pending bytes as possible. Returns false if the connection failed. */
+static bool connectionFlush(Object *connectionObject){
+    Connection *c = connection(connectionObject);
+    while (c->pendingOffset < c->pendingLength) {
+        ssize_t written = send(c->fd, c->pending + c->pendingOffset, c->pendingLength - c->pendingOffset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            return false;
+        }
+        c->pendingOffset += written;
+    }
+    if (c->pendingOffset == c->pendingLength) {
+        c->pendingOffset = c->pendingLength = 0;
+        if (c->closeRequested) {
+            connectionClose(connectionObject);
+            return true;
+        }
+    }
+    connectionUpdateInterest(connectionObject);
+    return true;
+}
+
+/** Appends the bytes to the pending bytes. */
+static bool connectionEnqueue(Connection *c, const char *bytes, size_t length){
+    if (c->pendingLength + length > c->pendingCapacity) {
+        size_t capacity = c->pendingCapacity ? c->pendingCapacity : 1024;
+        while (capacity < c->pendingLength + length) {
+            capacity *= 2;
+        }
+        char *pending = realloc(c->pending, capacity);
+        if (!pending) {
+            return false;
+        }
+        c->pending = pending;
+        c->pendingCapacity = capacity;
+    }
+    memcpy(c->pending + c->pendingLength, bytes, length);
+    c->pendingLength += length;
+    return true;
+}
+
+/** Opens a non-blocking socket for the address, which is looked up without holding up collections. */
+static int openSocket(Object *host, EmojicodeInteger port, bool passive, struct addrinfo **address, Thread *thread){
+    char *hostname = stringToChar(objectValue(host));
+    char service[24];
+    snprintf(service, sizeof(service), "%lld", (long long)port);
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM,
+                              .ai_flags = AI_NUMERICSERV | (passive ? AI_PASSIVE : 0) };
+    enterBlockingRegion(thread);
+    int state = getaddrinfo(hostname, service, &hints, address);
+    leaveBlockingRegion(thread);
+    free(hostname);
+
+    if (state != 0) {
+        return -1;
+    }
+
+    int fd = socket((*address)->ai_family, (*address)->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    (*address)->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(*address);
+    }
+    return fd;
+}
+
+static void connectionInit(Thread *thread){
+    connection(stackGetThis(thread))->fd = -1;
+
+    struct addrinfo *address;
+    int fd = openSocket(stackGetVariable(0, thread).object, unwrapInteger(stackGetVariable(1, thread)), false,
+                        &address, thread);
+    if (fd < 0) {
+        failInitializer(thread);
+        return;
+    }
+
+    int state = connect(fd, address->ai_addr, address->ai_addrlen);
+    freeaddrinfo(address);
+    if (state != 0 && errno != EINPROGRESS) {
+        close(fd);
+        failInitializer(thread);
+        return;
+    }
+
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    Object *connectionObject = stackGetThis(thread);
+    Object *loop = stackGetVariable(2, thread).object;
+    Connection *c = connection(connectionObject);
+    c->fd = fd;
+    c->loop = loop;
+    writeBarrier(connectionObject, somethingObject(loop));
+
+    if (!loopRegister(loop, fd, connectionObject, false)) {
+        close(fd);
+        c->fd = -1;
+        failInitializer(thread);
+        return;
+    }
+    c->connecting = state != 0;
+    connectionUpdateInterest(connectionObject);
+}
+
+static Something connectionSetReadCallback(Thread *thread){
+    Object *connectionObject = stackGetThis(thread);
+    Connection *c = connection(connectionObject);
+    if (c->fd >= 0) {
+        loopSetCallback(c->loop, c->fd, stackGetVariable(0, thread).object);
+        connectionUpdateInterest(connectionObject);
+    }
+    return NOTHINGNESS;
+}
+
+static Something connectionWrite(Thread *thread){
+    Object *connectionObject = stackGetThis(thread);
+    Connection *c = connection(connectionObject);
+    Data *data = objectValue(stackGetVariable(0, thread).object);
+
+    if (c->fd < 0 || c->closeRequested) {
+        return EMOJICODE_FALSE;
+    }
+
+    const char *bytes = data->bytes;
+    size_t length = data->length;
+
+    //Try to write directly if nothing is queued, the rest is written once the socket is writeable
+    if (!c->connecting && c->pendingLength == 0) {
+        ssize_t written = send(c->fd, bytes, length, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                //The failure is reported to the read callback by the next event
+                return EMOJICODE_FALSE;
+            }
+            written = 0;
+        }
+        bytes += written;
+        length -= written;
+    }
+    if (length > 0) {
+        if (!connectionEnqueue(c, bytes, length)) {
+            return EMOJICODE_FALSE;
+        }
+        connectionUpdateInterest(connectionObject);
+    }
+    return EMOJICODE_TRUE;
+}
+
+static Something connectionCloseBridge(Thread *thread){
+    Object *connectionObject = stackGetThis(thread);
+    Connection *c = connection(connectionObject);
+    if (c->fd >= 0 && c->pendingLength > c->pendingOffset) {
+        c->closeRequested = true;
+        eventLoop(c->loop)->registrations[c->fd].callback = NULL;
+        connectionUpdateInterest(connectionObject);
+    }
+    else {
+        connectionClose(connectionObject);
+    }
+    return NOTHINGNESS;
+}
+
+static void connectionMark(Object *self){
+    Connection *c = objectValue(self);
+    if (c->loop) {
+        mark(&c->loop);
+    }
+}
+
+/** A connection only becomes garbage if it was closed or if its loop became garbage too. */
+static void connectionDeinit(void *value){
+    Connection *c = value;
+    if (c->fd >= 0) {
+        close(c->fd);
+    }
+    free(c->pending);
+}
+
+//MARK: Servers
+
+static void serverInit(Thread *thread){
+    server(stackGetThis(thread))->fd = -1;
+
+    struct addrinfo *address;
+    int fd = openSocket(stackGetVariable(0, thread).object, unwrapInteger(stackGetVariable(1, thread)), true,
+                        &address, thread);
+    if (fd < 0) {
+        failInitializer(thread);
+        return;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int state = bind(fd, address->ai_addr, address->ai_addrlen);
+    freeaddrinfo(address);
+    if (state != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        failInitializer(thread);
+        return;
+    }
+
+    Object *serverObject = stackGetThis(thread);
+    Object *loop = stackGetVariable(2, thread).object;
+    server(serverObject)->fd = fd;
+    server(serverObject)->loop = loop;
+    writeBarrier(serverObject, somethingObject(loop));
+
+    if (!loopRegister(loop, fd, serverObject, true)) {
+        close(fd);
+        server(serverObject)->fd = -1;
+        failInitializer(thread);
+    }
+}
+
+static Something serverListen(Thread *thread){
+    Server *s = server(stackGetThis(thread));
+    if (s->fd >= 0) {
+        loopSetCallback(s->loop, s->fd, stackGetVariable(0, thread).object);
+        loopSetInterest(s->loop, s->fd, EPOLLIN);
+    }
+    return NOTHINGNESS;
+}
+
+static Something serverPort(Thread *thread){
+    Server *s = server(stackGetThis(thread));
+    struct sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    if (s->fd < 0 || getsockname(s->fd, (struct sockaddr *)&address, &length) != 0) {
+        return somethingInteger(-1);
+    }
+    if (address.ss_family == AF_INET6) {
+        return somethingInteger(ntohs(((struct sockaddr_in6 *)&address)->sin6_port));
+    }
+    return somethingInteger(ntohs(((struct sockaddr_in *)&address)->sin_port));
+}
+
+static Something serverClose(Thread *thread){
+    Server *s = server(stackGetThis(thread));
+    if (s->fd >= 0) {
+        loopUnregister(s->loop, s->fd);
+        s->fd = -1;
+    }
+    return NOTHINGNESS;
+}
+
+static void serverMark(Object *self){
+    Server *s = objectValue(self);
+    if (s->loop) {
+        mark(&s->loop);
+    }
+}
+
+static void serverDeinit(void *value){
+    Server *s = value;
+    if (s->fd >= 0) {
+        close(s->fd);
+    }
+}
+
+//MARK: Running the Loop
+
+/** Calls the callback registered for @c fd with @c argument, which must be reachable from the stack. */
+static void callCallback(int fd, Something argument, Thread *thread){
+    Object *callback = eventLoop(stackGetThis(thread))->registrations[fd].callback;
+    if (callback) {
+        executeCallableExtern(callback, &argument, thread);
+    }
+}
+
+/** Accepts pending connections and passes them to the accept callback. */
+static void loopAccept(int fd, Thread *thread){
+    for (int i = 0; i < acceptsPerEvent; i++) {
+        Registration *registration = eventLoop(stackGetThis(thread))->registrations + fd;
+        if (!registration->listening || !registration->callback) {
+            return;  //The server was closed by the callback
+        }
+
+        int client = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            return;
+        }
+        int noDelay = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        //The new connection is stored on the stack as it must survive the allocations
+        stackPush(stackGetThis(thread), 1, 0, thread);
+        stackSetVariable(0, somethingObject(newObject(connectionClass)), thread);
+
+        Object *loop = stackGetThis(thread);
+        Object *connectionObject = stackGetVariable(0, thread).object;
+        Connection *c = connection(connectionObject);
+        c->fd = client;
+        c->loop = loop;
+        writeBarrier(connectionObject, somethingObject(loop));
+
+        if (loopRegister(loop, client, connectionObject, false)) {
+            callCallback(fd, stackGetVariable(0, thread), thread);
+        }
+        else {
+            close(client);
+            c->fd = -1;
+        }
+        stackPop(thread);
+    }
+}
+
+/** Reads from the connection and passes the bytes, or nothingness if the connection was closed, to the callback. */
+static void loopRead(int fd, Thread *thread){
+    Object *connectionObject = eventLoop(stackGetThis(thread))->registrations[fd].socket;
+
+    char *bytes = malloc(readSize);
+    ssize_t length = bytes ? recv(fd, bytes, readSize, 0) : -1;
+    if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        free(bytes);
+        return;
+    }
+
+    stackPush(stackGetThis(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(connectionObject), thread);
+
+    if (length > 0) {
+        Object *dataObject = newObject(CL_DATA);
+        Data *data = objectValue(dataObject);
+        data->bytes = realloc(bytes, length);
+        data->length = length;
+        callCallback(fd, somethingObject(dataObject), thread);
+    }
+    else {
+        //The connection was closed by the peer or failed
+        free(bytes);
+        Something callback = somethingObject(eventLoop(stackGetThis(thread))->registrations[fd].callback);
+        connectionClose(stackGetVariable(0, thread).object);
+        if (callback.object) {
+            Something nothingness = NOTHINGNESS;
+            //The callback is not registered anymore and must therefore be kept alive by the stack
+            Something *variables = stackReserveFrame(stackGetThis(thread), 1, thread);
+            variables[0] = callback;
+            stackPushReservedFrame(thread);
+            executeCallableExtern(stackGetVariable(0, thread).object, &nothingness, thread);
+            stackPop(thread);
+        }
+    }
+    stackPop(thread);
+}
+
+/** Handles the event of a connection. */
+static void loopConnectionEvent(int fd, uint32_t events, Thread *thread){
+    Registration *registration = eventLoop(stackGetThis(thread))->registrations + fd;
+    Object *connectionObject = registration->socket;
+    Connection *c = connection(connectionObject);
+    bool failed = false;
+
+    if (c->connecting && events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+            failed = true;
+        }
+        c->connecting = false;
+    }
+    if (!failed && events & EPOLLOUT) {
+        failed = !connectionFlush(connectionObject);
+        if (c->fd < 0) {
+            return;  //Closed after writing all pending bytes
+        }
+    }
+
+    if (registration->callback && (failed || events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+        if (failed) {
+            //Make the read report the failure
+            shutdown(fd, SHUT_RDWR);
+        }
+        loopRead(fd, thread);
+    }
+    else if (failed || events & (EPOLLERR | EPOLLHUP)) {
+        connectionClose(connectionObject);
+    }
+}
+
+static Something loopRun(Thread *thread){
+    eventLoop(stackGetThis(thread))->stopped = false;
+
+    struct epoll_event events[eventsPerWait];
+    while (!eventLoop(stackGetThis(thread))->stopped && eventLoop(stackGetThis(thread))->socketCount > 0) {
+        int epoll = eventLoop(stackGetThis(thread))->epoll;
+        enterBlockingRegion(thread);
+        int count = epoll_wait(epoll, events, eventsPerWait, -1);
+        leaveBlockingRegion(thread);
+
+        for (int i = 0; i < count && !eventLoop(stackGetThis(thread))->stopped; i++) {
+            int fd = events[i].data.fd;
+            //The socket might have been closed by a previous callback
+            Registration *registration = eventLoop(stackGetThis(thread))->registrations + fd;
+            if (!registration->socket) {
+                continue;
+            }
+            if (registration->listening) {
+                loopAccept(fd, thread);
+            }
+            else {
+                loopConnectionEvent(fd, events[i].events, thread);
+            }
+        }
+    }
+    return NOTHINGNESS;
+}
+
+static Something loopStop(Thread *thread){
+    eventLoop(stackGetThis(thread))->stopped = true;
+    return NOTHINGNESS;
+}
+
+//MARK: Package
+
+ClassMethodHandler handlerPointerForClassMethod(EmojicodeChar cl, EmojicodeChar symbol){
+    return NULL;
+}
+
+MethodHandler handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar symbol){
+    switch (cl) {
+        case 0x1F300: //🌀
+            switch (symbol) {
+                case 0x1F3C3: //🏃
+                    return loopRun;
+                case 0x23F9: //⏹
+                    return loopStop;
+            }
+            break;
+        case 0x1F4E1: //📡
+            switch (symbol) {
+                case 0x1F442: //👂
+                    return serverListen;
+                case 0x1F682: //🚂
+                    return serverPort;
+                case 0x1F6AA: //🚪
+                    return serverClose;
+            }
+            break;
+        case 0x1F4DE: //📞
+            switch (symbol) {
+                case 0x1F4D3: //📓
+                    return connectionSetReadCallback;
+                case 0x270F: //✏️
+                    return connectionWrite;
+                case 0x1F6AA: //🚪
+                    return connectionCloseBridge;
+            }
+            break;
+    }
+    return NULL;
+}
+
+InitializerHandler handlerPointerForInitializer(EmojicodeChar cl, EmojicodeChar symbol){
+    switch (cl) {
+        case 0x1F300:
+            return loopInit;
+        case 0x1F4E1:
+            return serverInit;
+        case 0x1F4DE:
+            return connectionInit;
+    }
+    return NULL;
+}
+
+Marker markerPointerForClass(EmojicodeChar cl){
+    switch (cl) {
+        case 0x1F300:
+            return loopMark;
+        case 0x1F4E1:
+            return serverMark;
+        case 0x1F4DE:
+            return connectionMark;
+    }
+    return NULL;
+}
+
+uint_fast32_t sizeForClass(Class *cl, EmojicodeChar name) {
+    switch (name) {
+        case 0x1F300:
+            return sizeof(EventLoop);
+        case 0x1F4E1:
+            return sizeof(Server);
+        case 0x1F4DE:
+            //Accepted connections are created by the loop
+            connectionClass = cl;
+            return sizeof(Connection);
+    }
+    return 0;
+}
+
+Deinitializer deinitializerPointerForClass(EmojicodeChar cl){
+    switch (cl) {
+        case 0x1F300:
+            return loopDeinit;
+        case 0x1F4E1:
+            return serverDeinit;
+        case 0x1F4DE:
+            return connectionDeinit;
+    }
+    return NULL;
+}
@@ -13,21 +13,21 @@
 #include "sqlite3.h"
 #include <string.h>
 
-#define goSqlite3(obj) (*((sqlite3**)(obj)->value))
-#define goSqlite3_stmt(obj) (*((sqlite3_stmt**)(obj)->value))
+#define goSqlite3(obj) (*((sqlite3**)objectValue(obj)))
+#define goSqlite3_stmt(obj) (*((sqlite3_stmt**)objectValue(obj)))
 
 PackageVersion getVersion(){
     return (PackageVersion){0, 1};
 }
 
 static void bridgeSQLiteOpen(Thread *thread){
-    char *path = stringToChar(stackGetVariable(0, thread).object->value);
-    int state = sqlite3_open(path, (sqlite3**)stackGetThis(thread)->value);
+    char *path = stringToChar(objectValue(stackGetVariable(0, thread).object));
+    int state = sqlite3_open(path, (sqlite3**)objectValue(stackGetThis(thread)));
     free(path);
     
     if(state != SQLITE_OK){
-        stackGetThis(thread)->value = NULL;
         puts(sqlite3_errmsg(goSqlite3(stackGetThis(thread))));
+        failInitializer(thread);
     }
 }
 
@@ -36,7 +36,7 @@ static void bridgeSQLiteRelease(void *db){
 }
 
 static void bridgeSQLitePrepare(Thread *thread){
-    char *sql = stringToChar(stackGetVariable(1, thread).object->value);
+    char *sql = stringToChar(objectValue(stackGetVariable(1, thread).object));
     sqlite3_stmt *statement;
     if(sqlite3_prepare_v2(goSqlite3(stackGetVariable(0, thread).object), sql, -1, &statement, NULL) != SQLITE_OK){
         puts(sqlite3_errmsg(goSqlite3(stackGetVariable(0, thread).object)));
@@ -50,22 +50,22 @@ static Something bridgeSQLiteBindInteger(Thread *thread){
     Something toBind = stackGetVariable(1, thread);
     
     int state;
-    if(toBind.type == T_INTEGER){
+    if(somethingType(toBind) == T_INTEGER){
         state = sqlite3_bind_int(goSqlite3_stmt(stackGetThis(thread)), (int)i, (int)unwrapInteger(toBind));
     }
-    else if(toBind.type == T_OBJECT && instanceof(toBind.object, CL_STRING)){
-            String *string = toBind.object->value;
-            char *text = stringToChar(string);
-            state = sqlite3_bind_text(goSqlite3_stmt(stackGetThis(thread)), (int)i, text, (int)string->length, free);
+    else if(isRealObject(toBind) && instanceof(toBind.object, CL_STRING)){
+            size_t length;
+            char *text = stringToUTF8(objectValue(toBind.object), &length);
+            state = sqlite3_bind_text(goSqlite3_stmt(stackGetThis(thread)), (int)i, text, (int)length, free);
     }
-    else if(toBind.type == T_OBJECT && instanceof(toBind.object, CL_DATA)){
-        Data *data = toBind.object->value;
+    else if(isRealObject(toBind) && instanceof(toBind.object, CL_DATA)){
+        Data *data = objectValue(toBind.object);
         char* bytes = malloc(data->length);
         memcpy(bytes, data->bytes, data->length);
         state = sqlite3_bind_blob(goSqlite3_stmt(stackGetThis(thread)), (int)i, bytes, (int)data->length, free);
     }
-//    else if(toBind.type == T_FLOAT){
-//        state = sqlite3_bind_double(stackGetThis(thread)->value, i, *(float *)toBind->value);
+//    else if(somethingType(toBind) == T_DOUBLE){
+//        state = sqlite3_bind_double(objectValue(stackGetThis(thread)), i, *(float *)objectValue(toBind));
 //    }
     else if(isNothingness(toBind)){
         state = sqlite3_bind_null(goSqlite3_stmt(stackGetThis(thread)), (int)i);
@@ -81,15 +81,15 @@ static Something bridgeSQLiteBindInteger(Thread *thread){
 }
 
 static Something bridgeSQLiteLastError(Thread *thread){
-    int code = sqlite3_errcode(stackGetThis(thread)->value);
+    int code = sqlite3_errcode(objectValue(stackGetThis(thread)));
     if (code != SQLITE_OK) {
-        return somethingObject(newError(sqlite3_errmsg(stackGetThis(thread)->value), code));
+        return somethingObject(newError(sqlite3_errmsg(objectValue(stackGetThis(thread))), code));
     }
     return NOTHINGNESS;
 }
 
 static Something bridgeSQLiteLastInsertID(Thread *thread){
-    return somethingInteger((EmojicodeInteger)sqlite3_last_insert_rowid(stackGetThis(thread)->value));
+    return somethingInteger((EmojicodeInteger)sqlite3_last_insert_rowid(objectValue(stackGetThis(thread))));
 }
 
 static Something bridgeSQLiteStep(Thread *thread){
@@ -119,7 +119,7 @@ static Something bridgeSQLiteStep(Thread *thread){
                     return NOTHINGNESS;
                 }
             
-                listAppend(stackGetVariable(1, thread).object->value, somethingObject(stringFromChar(colname)), thread);
+                listAppend(objectValue(stackGetVariable(1, thread).object), somethingObject(stringFromChar(colname)), thread);
             }
                 
             Something sth = NOTHINGNESS;
@@ -131,7 +131,8 @@ static Something bridgeSQLiteStep(Thread *thread){
                 case SQLITE_TEXT: {
                     const char *text = (const char*)sqlite3_column_text(goSqlite3_stmt(stackGetThis(thread)), i);
                     if(text != NULL){
-                        sth = somethingObject(stringFromChar(text));
+                        int length = sqlite3_column_bytes(goSqlite3_stmt(stackGetThis(thread)), i);
+                        sth = somethingObject(stringFromUTF8(text, length));
                     }
                     break;
                 }
@@ -141,7 +142,7 @@ static Something bridgeSQLiteStep(Thread *thread){
                         int length = sqlite3_column_bytes(goSqlite3_stmt(stackGetThis(thread)), i);
                         
                         Object *datao = newObject(CL_DATA);
-                        Data *data = datao->value;
+                        Data *data = objectValue(datao);
                         
                         char* bytes = malloc(length);
                         memcpy(bytes, data, length);
@@ -160,10 +161,10 @@ static Something bridgeSQLiteStep(Thread *thread){
                 // SQLITE_NULL: nothing to do
             }
             
-            dictionarySet(stackGetVariable(2, thread).object->value, listGet(stackGetVariable(1, thread).object->value, i).object, sth, thread);
+            dictionarySet(objectValue(stackGetVariable(2, thread).object), listGet(objectValue(stackGetVariable(1, thread).object), i), sth, thread);
         }
         
-        listAppend(stackGetVariable(0, thread).object->value, somethingObject(dicto), thread);
+        listAppend(objectValue(stackGetVariable(0, thread).object), somethingObject(dicto), thread);
     }
     Something sth = stackGetVariable(0, thread);
     stackPop(thread);
@@ -17,6 +17,7 @@
 #define EmojicodeAPI_h
 
 #include "EmojicodeShared.h"
+#include <string.h>
 
 typedef struct Class Class;
 typedef struct Method Method;
@@ -34,22 +35,29 @@ extern Class *CL_DICTIONARY;
 extern Class *CL_ENUMERATOR;
 extern Class *CL_CAPTURED_METHOD_CALL;
 extern Class *CL_CLOSURE;
+extern Class *CL_DICTIONARY_ENTRY_ENUMERATOR;
+extern Class *CL_DICTIONARY_VALUE_ENUMERATOR;
 
+/**
+ * The header of every object. It is followed by the object’s value area and its instance variables.
+ * Use @c objectValue to access the value area.
+ */
 typedef struct Object {
-    /** The object’s class. */
+    /**
+     * The object’s class.
+     * @warning The Garbage Collector stores forwarding pointers in this field while it is collecting.
+     */
     Class *class;
-    /** The size of this object: the size of the Object struct and the value area. */
-    size_t size;
-    /** The objects garabage collection state */
-    struct Object *newLocation;
     /**
-     * A pointer to the allocated @c value area. This area is as large as specified in the class.
-     * @warning Never change the content of this variable as the Garbage Collector updates this field
-     * in each cycle.
+     * The size of this object: the size of the Object struct, the value area and the instance variables.
+     * @warning The lowest three bits are used by the Garbage Collector.
      */
-    void *value;
+    size_t size;
 } Object;
 
+/** Returns a pointer to the value area of @c object. This area is as large as specified in the class. */
+#define objectValue(object) ((void *)((Byte *)(object) + sizeof(Object)))
+
 
 #define T_OBJECT 0
 #define T_INTEGER 1
@@ -60,47 +68,159 @@ typedef struct Object {
 typedef uint_fast8_t Type;
 typedef unsigned char Byte;
 
-/** Either a object reference or a primitive value. */
-typedef struct {
-    /** The type of the primitive or whether it contains an object reference. */
-    Type type;
-    union {
-        EmojicodeInteger raw;
-        double doubl;
-        Object *object;
-    };
+/**
+ * Either a object reference or a primitive value, encoded in 64 bits.
+ *
+ * The upper 16 bits determine what a Something contains:
+ * - @c 0x0000: An object reference. Nothingness is represented by @c 0, i.e. by a @c NULL reference.
+ * - @c 0x0001 to @c 0xFFF1: A double. The bits of the double offset by 2^48. All NaNs are stored as the same NaN.
+ * - @c 0xFFF2: A boolean.
+ * - @c 0xFFF3: A symbol.
+ * - @c 0xFFF8 to @c 0xFFFF: An integer in the range -2^50 to 2^50 - 1.
+ *
+ * Integers outside this range are stored in boxes, objects that are allocated on the heap by @c somethingInteger.
+ * Use @c unwrapInteger to retrieve the value of any integer. Boxing an integer never invokes the Garbage Collector,
+ * but like every object a box moves during a collection. Do not keep a Something that might contain an integer in a
+ * local variable across a GC-invoking call, unwrap it first.
+ */
+typedef union {
+    /** The encoded value. Use the unwrap functions to decode it. */
+    uint64_t bits;
+    /** The object reference. Only valid if the Something contains an object. */
+    Object *object;
 } Something;
 
 #if __SIZEOF_DOUBLE__ != 8
 #warning Double does not match the size of an 64-bit integer
 #endif
 
-#define somethingObject(o) ((Something){T_OBJECT, .object = (o)})
-#define somethingInteger(o) ((Something){T_INTEGER, (o)})
-#define somethingSymbol(o) ((Something){T_SYMBOL, (o)})
-#define somethingBoolean(o) ((Something){T_BOOLEAN, (o)})
-#define somethingDouble(o) ((Something){T_DOUBLE, .doubl = (o)})
-#define EMOJICODE_TRUE ((Something){T_BOOLEAN, 1})
-#define EMOJICODE_FALSE ((Something){T_BOOLEAN, 0})
-#define NOTHINGNESS ((Something){T_OBJECT, .object = NULL})
+#define SOMETHING_DOUBLE_OFFSET ((uint64_t)1 << 48)
+#define SOMETHING_BOOLEAN_TAG ((uint64_t)0xFFF2 << 48)
+#define SOMETHING_SYMBOL_TAG ((uint64_t)0xFFF3 << 48)
+#define SOMETHING_INTEGER_TAG ((uint64_t)0xFFF8 << 48)
+#define SOMETHING_INTEGER_MASK (((uint64_t)1 << 51) - 1)
+#define SOMETHING_CANONICAL_NAN ((uint64_t)0x7FF8 << 48)
 
-#define unwrapInteger(o) ((o).raw)
-#define unwrapLong(o) (*(EmojicodeLong *)((o)->value))
-#define unwrapBool(o) ((o).raw > 0)
-#define unwrapSymbol(o) ((EmojicodeChar)(o).raw)
+/** Whether @c i can be stored in a Something without being boxed. */
+#define integerFitsInline(i) (((EmojicodeInteger)((uint64_t)(i) << 13) >> 13) == (EmojicodeInteger)(i))
+#define isInlineInteger(s) ((s).bits >= SOMETHING_INTEGER_TAG)
+#define isEncodedObject(s) ((s).bits >> 48 == 0)
+
+/**
+ * Allocates a box for an integer that does not fit into a Something.
+ * @warning Allocates memory but never invokes the Garbage Collector.
+ */
+extern Object* boxInteger(EmojicodeInteger i);
+
+/** Returns the value of an integer box. */
+extern EmojicodeInteger unboxInteger(Object *box);
+
+/** Whether @c o is an integer box. */
+extern bool isIntegerBox(Object *o);
+
+static inline Something somethingObject(Object *o){
+    return (Something){ .object = o };
+}
+
+static inline Something somethingInteger(EmojicodeInteger i){
+    if (integerFitsInline(i)) {
+        return (Something){ .bits = SOMETHING_INTEGER_TAG | ((uint64_t)i & SOMETHING_INTEGER_MASK) };
+    }
+    return (Something){ .object = boxInteger(i) };
+}
+
+static inline Something somethingSymbol(EmojicodeChar c){
+    return (Something){ .bits = SOMETHING_SYMBOL_TAG | c };
+}
+
+static inline Something somethingBoolean(bool b){
+    return (Something){ .bits = SOMETHING_BOOLEAN_TAG | (b ? 1 : 0) };
+}
+
+static inline Something somethingDouble(double d){
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    //Compare the bits as the engine is compiled with -ffast-math
+    if ((bits & ~((uint64_t)1 << 63)) > ((uint64_t)0x7FF0 << 48)) {
+        bits = SOMETHING_CANONICAL_NAN;
+    }
+    return (Something){ .bits = bits + SOMETHING_DOUBLE_OFFSET };
+}
+
+#define EMOJICODE_TRUE ((Something){ .bits = SOMETHING_BOOLEAN_TAG | 1 })
+#define EMOJICODE_FALSE ((Something){ .bits = SOMETHING_BOOLEAN_TAG })
+#define NOTHINGNESS ((Something){ .bits = 0 })
+
+static inline EmojicodeInteger unwrapInteger(Something s){
+    if (isInlineInteger(s)) {
+        return (EmojicodeInteger)(s.bits << 13) >> 13;
+    }
+    return unboxInteger(s.object);
+}
+
+static inline double unwrapDouble(Something s){
+    uint64_t bits = s.bits - SOMETHING_DOUBLE_OFFSET;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+#define unwrapLong(o) (*(EmojicodeLong *)(objectValue(o)))
+#define unwrapBool(o) ((bool)((o).bits & 1))
+#define unwrapSymbol(o) ((EmojicodeChar)(o).bits)
+
+/** Returns which kind of value @c s contains. Integer boxes are reported as @c T_INTEGER. */
+static inline Type somethingType(Something s){
+    if (isEncodedObject(s)) {
+        return s.object && isIntegerBox(s.object) ? T_INTEGER : T_OBJECT;
+    }
+    if (isInlineInteger(s)) {
+        return T_INTEGER;
+    }
+    switch (s.bits >> 48) {
+        case 0xFFF2:
+            return T_BOOLEAN;
+        case 0xFFF3:
+            return T_SYMBOL;
+        default:
+            return T_DOUBLE;
+    }
+}
+
+/** Whether @c a and @c b contain the same primitive value. */
+static inline bool somethingPrimitivesEqual(Something a, Something b){
+    if (a.bits == b.bits) {
+        return true;
+    }
+    //Boxed integers are only equal if both integers are boxed
+    return isEncodedObject(a) && isEncodedObject(b) && a.object && b.object && isIntegerBox(a.object)
+            && isIntegerBox(b.object) && unboxInteger(a.object) == unboxInteger(b.object);
+}
 
 extern bool isNothingness(Something sth);
 
-/** Whether this thing is a reference to a valid object. */
+/** Whether this thing is a reference to a valid object. Integer boxes are objects as well. */
 extern bool isRealObject(Something sth);
 
 //MARK: Built In Classes
 
+/**
+ * A string is stored compactly, with one byte per code point (Latin-1), if all its code points are not greater than
+ * U+00FF, and with one @c EmojicodeChar per code point otherwise. Every function creating a string must choose the
+ * compact storage if possible, so that equal strings are always stored alike. Use the functions in
+ * @c EmojicodeString.h to access the code points.
+ */
 typedef struct String {
     /** The number of code points in @c characters. Strings are not null terminated! */
     EmojicodeInteger length;
     /** The characters of this string. Strings are not null terminated! */
     Object *characters;
+    /** The index in @c characters of the first code point. Substrings share the characters of their string. */
+    EmojicodeInteger offset;
+    /** The hash of the characters, or 0 if it was not calculated yet. Only accessed through @c stringHash. */
+    uint64_t hash;
+    /** Whether @c characters stores one byte per code point. */
+    bool compact;
 } String;
 
 typedef struct {
@@ -126,7 +246,7 @@ extern Something executeCallableExtern(Object *callable, Something *args, Thread
 
 /**
  * Allocates a new object for the given class.
- * The @c value field will point to a value area as large as specified for the given class.
+ * The value area of the object, see @c objectValue, will be as large as specified for the given class.
  * @param class The class of the object.
  * @warning GC-invoking
  */
@@ -169,6 +289,26 @@ extern bool instanceof(Object *object, Class *cl);
  */
 extern void mark(Object **of);
 
+/**
+ * The write barrier of the generational Garbage Collector.
+ * You must call this function after you stored a reference to @c value in @c owner or in an object only reachable
+ * through @c owner (like the items array of a list), unless no object was allocated since @c owner was allocated.
+ */
+extern void writeBarrier(Object *owner, Something value);
+
+
+//MARK: Threads
+
+/**
+ * Tells the collector that the thread will not access the heap until @c leaveBlockingRegion is called, so that
+ * collections do not need to wait for it. Must be called before blocking system calls. All objects the thread still
+ * needs must be reachable from its stack.
+ */
+extern void enterBlockingRegion(Thread *thread);
+
+/** Waits until no collection is being performed and lets the thread access the heap again. */
+extern void leaveBlockingRegion(Thread *thread);
+
 
 //MARK: Stack
 
@@ -200,6 +340,9 @@ void stackPushReservedFrame(Thread *thread);
 /** Returns the object on which the method was called. */
 Object* stackGetThis(Thread *);
 
+/** Call this function from a native initializer to make the initializer return nothingness. */
+void failInitializer(Thread *thread);
+
 /** Returns the class on which the method was called. */
 Class* stackGetThisClass(Thread *thread);
 
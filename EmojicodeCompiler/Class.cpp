@@ -10,6 +10,7 @@
 #include "Class.hpp"
 #include "Procedure.hpp"
 #include "utf8.h"
+#include <algorithm>
 
 Class* getClass(EmojicodeChar name, EmojicodeChar enamespace){
     std::array<EmojicodeChar, 2> ns = {enamespace, name};
@@ -19,7 +20,7 @@ Class* getClass(EmojicodeChar name, EmojicodeChar enamespace){
 
 bool Class::conformsTo(Protocol *to){
     for(Class *a = this; a != nullptr; a = a->superclass){
-        for(size_t i = 0; i < this->protocols_.size(); i++){
+        for(size_t i = 0; i < a->protocols_.size(); i++){
             if(a->protocols_[i] == to) {
                 return true;
             }
@@ -100,6 +101,18 @@ void Class::addProtocol(Protocol *protocol){
     protocols_.push_back(protocol);
 }
 
+std::vector<Protocol*> Class::allProtocols(){
+    std::vector<Protocol*> protocols;
+    for(Class *a = this; a != nullptr; a = a->superclass){
+        for(auto protocol : a->protocols_){
+            if(std::find(protocols.begin(), protocols.end(), protocol) == protocols.end()){
+                protocols.push_back(protocol);
+            }
+        }
+    }
+    return protocols;
+}
+
 //MARK: Protocol
 
 Protocol* getProtocol(EmojicodeChar name, EmojicodeChar enamespace){
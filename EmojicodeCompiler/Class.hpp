@@ -75,6 +75,8 @@ public:
     void addProtocol(Protocol *protocol);
     
     const std::vector<Protocol*>& protocols() { return protocols_; };
+    /** Returns the protocols this class agrees to, including the ones its superclasses agree to. */
+    std::vector<Protocol*> allProtocols();
 private:
     std::map<EmojicodeChar, Method *> methods;
     std::map<EmojicodeChar, ClassMethod *> classMethods;
@@ -90,7 +90,9 @@ enum Emojis {
     E_HOT_PEPPER = 0x1F336,
     E_LOLLIPOP = 0x1F36D,
     E_SOFT_ICE_CREAM = 0x1F366,
-    E_CHIPMUNK = 0x1F43F
+    E_CHIPMUNK = 0x1F43F,
+    E_DANGO = 0x1F361,
+    E_FROG = 0x1F438
 };
 
 #endif /* Emojis_h */
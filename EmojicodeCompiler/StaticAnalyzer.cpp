@@ -75,16 +75,18 @@ void analyzeClass(Type classType, Writer &writer){
         compilerWarning(eclass->classBegin, "Class %s defines %d instances variables but has no initializers.", str.c_str(), eclass->instanceVariables.size());
     }
     
-    writer.writeUInt16(eclass->protocols().size());
+    //Inherited protocols are written as well, as the agreements must refer to the methods of this class
+    auto protocols = eclass->allProtocols();
+    writer.writeUInt16(protocols.size());
     
-    if (eclass->protocols().size() > 0) {
+    if (protocols.size() > 0) {
         auto biggestPlaceholder = writer.writePlaceholder<uint16_t>();
         auto smallestPlaceholder = writer.writePlaceholder<uint16_t>();
 
         uint_fast16_t smallestProtocolIndex = UINT_FAST16_MAX;
         uint_fast16_t biggestProtocolIndex = 0;
         
-        for (auto protocol : eclass->protocols()) {
+        for (auto protocol : protocols) {
             writer.writeUInt16(protocol->index);
             
             if (protocol->index > biggestProtocolIndex) {
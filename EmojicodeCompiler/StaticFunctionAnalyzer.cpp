@@ -58,6 +58,7 @@ void StaticFunctionAnalyzer::checkArguments(Arguments arguments, Type calledType
         consumeToken();
         brackets = true;
     }
+    writer.writeCoin((EmojicodeCoin)arguments.size());
     for (auto var : arguments) {
         parse(consumeToken(), token, var.type.resolveOn(calledType));
     }
@@ -358,6 +359,7 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
         case E_ICE_CREAM: {
             writer.writeCoin(0x51);
             
+            auto storagePlaceholder = writer.writeCoinPlaceholder();
             auto placeholder = writer.writeCoinsCountPlaceholderCoin();
             
             CommonTypeFinder ct;
@@ -372,6 +374,7 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             Type type = Type(CL_LIST);
             type.genericArguments[0] = ct.getCommonType(token);
             
+            storagePlaceholder.write(type.listStorage());
             return type;
         }
         case E_HONEY_POT: {
@@ -380,10 +383,13 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             auto placeholder = writer.writeCoinsCountPlaceholderCoin();
             
             CommonTypeFinder ct;
+            CommonTypeFinder keyTypeFinder;
+            bool hasKeys = false;
             
             const Token *aToken;
             while (aToken = consumeToken(), !(aToken->type == IDENTIFIER && aToken->value[0] == E_AUBERGINE)) {
-                parse(aToken, token, Type(CL_STRING));
+                keyTypeFinder.addType(parse(aToken, token), contextType);
+                hasKeys = true;
                 ct.addType(parse(consumeToken(), token), contextType);
             }
             
@@ -391,6 +397,8 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             
             Type type = Type(CL_DICTIONARY);
             type.genericArguments[0] = ct.getCommonType(token);
+            //An empty dictionary literal is keyed by strings like a dictionary declared with only one generic argument
+            type.genericArguments[1] = hasKeys ? keyTypeFinder.getCommonType(token) : Type(CL_STRING);
             
             return type;
         }
@@ -451,8 +459,20 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             else if(iteratee.compatibleTo(Type(PR_ENUMERATEABLE, false), contextType)) {
                 placeholder.write(0x64);
                 Type itemType = typeSomething;
-                if(iteratee.type == TT_CLASS && iteratee.eclass->ownGenericArgumentCount == 1) {
-                    itemType = iteratee.genericArguments[iteratee.eclass->ownGenericArgumentCount - iteratee.eclass->genericArgumentCount];
+                Method *enumeratorMethod = iteratee.type == TT_CLASS ? iteratee.eclass->getMethod(E_DANGO) : nullptr;
+                if(enumeratorMethod) {
+                    //The items are of the type of the Element argument of the 🍡 that is returned by 🍡
+                    Type enumerator = enumeratorMethod->returnType.resolveOn(iteratee);
+                    if (enumerator.type == TT_CLASS && enumerator.eclass->genericArgumentCount > 0) {
+                        bool resolved = false;
+                        Type element = Type(TT_REFERENCE, false, 0).resolveOnSuperArguments(enumerator.eclass, &resolved);
+                        if (element.type == TT_REFERENCE) {
+                            itemType = enumerator.genericArguments[element.reference];
+                        }
+                        else {
+                            itemType = element;
+                        }
+                    }
                 }
                 scoper.currentScope()->setLocalVariable(variableToken, new CompilerVariable(itemType, vID, true, true, variableToken));
             }
@@ -491,8 +511,6 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             return contextType;
         }
         case E_UP_POINTING_RED_TRIANGLE: {
-            writer.writeCoin(0x13);
-            
             Type type = Type::parseAndFetchType(contextType, currentNamespace, dynamismLevelFromSI(), nullptr);
             
             if (type.type != TT_ENUM) {
@@ -510,19 +528,19 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
                 ecCharToCharStack(type.eenum->name, enumName);
                 compilerError(name, "%s does not have a member named %s.", enumName, valueName);
             }
-            else if (v.second > UINT32_MAX) {
+            else if (v.second > INT32_MAX) {
+                writer.writeCoin(0x14);
                 writer.writeCoin(v.second >> 32);
                 writer.writeCoin((EmojicodeCoin)v.second);
             }
             else {
+                writer.writeCoin(0x13);
                 writer.writeCoin((EmojicodeCoin)v.second);
             }
             
             return type;
         }
         case E_LARGE_BLUE_DIAMOND: {
-            writer.writeCoin(0x4);
-            
             bool dynamic;
             Type type = Type::parseAndFetchType(contextType, currentNamespace, dynamismLevelFromSI(), &dynamic);
             
@@ -533,6 +551,19 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
                 compilerError(token, "Optionals cannot be initiatied.");
             }
             
+            //The initializer name
+            const Token *name = consumeToken(IDENTIFIER);
+            
+            if (!dynamic && type.eclass == CL_LIST && name->value[0] == E_FROG && type.listStorage() != LIST_STORAGE_SOMETHING) {
+                //An empty list literal is written instead, which tells the Real-Time Engine how to store the elements
+                writer.writeCoin(0x51);
+                writer.writeCoin(type.listStorage());
+                writer.writeCoin(0);
+                return type;
+            }
+            
+            writer.writeCoin(0x4);
+            
             if (dynamic) {
                 writer.writeCoin(UINT32_MAX);
             }
@@ -540,9 +571,6 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
                 writer.writeCoin(type.eclass->index);
             }
             
-            //The initializer name
-            const Token *name = consumeToken(IDENTIFIER);
-            
             Initializer *initializer = type.eclass->getInitializer(name->value[0]);
             
             if (initializer == nullptr) {
@@ -728,11 +756,12 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             }
             
             writer.writeCoin(method->vti);
-            placeholder.write();
             
             checkAccess(method, token, "method");
             checkArguments(method->arguments, type, token);
             
+            placeholder.write();
+            
             Type returnType = method->returnType;
             returnType.optional = true;
             return returnType;
@@ -807,7 +836,7 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
             function.firstToken = currentToken;
             
             auto sca = StaticFunctionAnalyzer(function, currentNamespace, nullptr, inClassContext, contextType, writer, scoper);
-            sca.analyze(true, closingScope);
+            sca.analyze(true, closingScope, variableCount);
             
             if (!inClassContext) {
                 scoper.popScope();
@@ -829,6 +858,7 @@ Type StaticFunctionAnalyzer::unsafeParseIdentifier(const Token *token){
                 compilerError(token, "Given value is not callable.");
             }
             
+            writer.writeCoin(type.arguments);
             for (int i = 1; i <= type.arguments; i++) {
                 parse(consumeToken(), token, type.genericArguments[i]);
             }
@@ -1013,7 +1043,7 @@ StaticFunctionAnalyzer::StaticFunctionAnalyzer(Callable &callable, EmojicodeChar
     
 }
 
-void StaticFunctionAnalyzer::analyze(bool compileDeadCode, Scope *copyScope){
+void StaticFunctionAnalyzer::analyze(bool compileDeadCode, Scope *copyScope, uint8_t capturedVariableCount){
     currentToken = callable.firstToken;
     
     if (initializer) {
@@ -1030,7 +1060,8 @@ void StaticFunctionAnalyzer::analyze(bool compileDeadCode, Scope *copyScope){
     }
     
     if (copyScope) {
-        variableCount += methodScope.copyFromScope(copyScope, nextVariableID());
+        methodScope.copyFromScope(copyScope, variableCount);
+        variableCount += capturedVariableCount;
     }
     
     scoper.pushScope(&methodScope);
@@ -21,8 +21,13 @@ public:
     static void writeAndAnalyzeProcedure(Procedure &procedure, Writer &writer, Type classType, Scoper &scoper, bool inClassContext = false, Initializer *i = nullptr);
     StaticFunctionAnalyzer(Callable &callable, EmojicodeChar ns, Initializer *i, bool inClassContext, Type contextType, Writer &writer, Scoper &scoper);
     
-    /** Performs the analyziation. */
-    void analyze(bool compileDeadCode = false, Scope *copyScope = nullptr);
+    /**
+     * Performs the analyziation.
+     * @param copyScope The scope whose variables are captured by a closure.
+     * @param capturedVariableCount The number of variables of the enclosing function, which are all copied behind the
+     *                              arguments of the closure.
+     */
+    void analyze(bool compileDeadCode = false, Scope *copyScope = nullptr, uint8_t capturedVariableCount = 0);
     /** Whether self was used in the callable body. */
     bool usedSelfInBody() { return usedSelf; };
     /** The number of local variables created in the function. */
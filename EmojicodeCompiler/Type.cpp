@@ -50,6 +50,22 @@ Type Type::resolveOnSuperArguments(Class *c, bool *resolved){
     }
 }
 
+ListStorage Type::listStorage() const{
+    if (type != TT_CLASS || eclass != CL_LIST || genericArguments[0].optional) {
+        return LIST_STORAGE_SOMETHING;
+    }
+    switch (genericArguments[0].type) {
+        case TT_INTEGER:
+            return LIST_STORAGE_INTEGER;
+        case TT_DOUBLE:
+            return LIST_STORAGE_DOUBLE;
+        case TT_SYMBOL:
+            return LIST_STORAGE_SYMBOL;
+        default:
+            return LIST_STORAGE_SOMETHING;
+    }
+}
+
 /** Returns the name of a type */
 
 bool Type::compatibleTo(Type to, Type contextType){
@@ -169,6 +185,21 @@ Type Type::fetchRawType(EmojicodeChar name, EmojicodeChar enamespace, bool optio
     return typeNothingness;
 }
 
+/** Replaces the references in @c type, which refer to the generic arguments of @c t, with these arguments. */
+static Type substituteArguments(Type type, const Type &t){
+    if (type.type == TT_REFERENCE) {
+        bool optional = type.optional;
+        type = t.genericArguments[type.reference];
+        type.optional = type.optional || optional;
+    }
+    else if (type.type == TT_CLASS) {
+        for (size_t i = 0; i < type.genericArguments.size(); i++) {
+            type.genericArguments[i] = substituteArguments(type.genericArguments[i], t);
+        }
+    }
+    return type;
+}
+
 Type Type::resolveOn(Type o){
     Type t = *this;
     bool optional = t.optional;
@@ -177,7 +208,18 @@ Type Type::resolveOn(Type o){
     }
     t.optional = optional;
     if (t.type == TT_CLASS) {
-        for (int i = 0; i < t.eclass->genericArgumentCount; i++) {
+        int superArgumentCount = t.eclass->genericArgumentCount - t.eclass->ownGenericArgumentCount;
+        for (int i = superArgumentCount; i < t.eclass->genericArgumentCount; i++) {
+            t.genericArguments[i] = t.genericArguments[i].resolveOn(o);
+        }
+        //The arguments of the superclass refer to the arguments of the class itself and not to o. They are resolved
+        //backwards since they only refer to arguments behind them.
+        for (int i = superArgumentCount - 1; i >= 0; i--) {
+            t.genericArguments[i] = substituteArguments(t.eclass->superGenericArguments[i], t);
+        }
+    }
+    else if (t.type == TT_CALLABLE) {
+        for (size_t i = 0; i < t.genericArguments.size(); i++) {
             t.genericArguments[i] = t.genericArguments[i].resolveOn(o);
         }
     }
@@ -330,6 +372,12 @@ void Type::parseGenericArguments(Type contextType, EmojicodeChar theNamespace, T
                 count++;
             }
             
+            //🍯🐚Element without a key type is a dictionary keyed by strings
+            if (this->eclass == CL_DICTIONARY && count == 1) {
+                genericArguments.push_back(Type(CL_STRING));
+                count++;
+            }
+            
             if(count != this->eclass->ownGenericArgumentCount){
                 auto str = this->toString(typeNothingness, false);
                 compilerError(errorToken, "Type %s requires %d generic arguments, but %d were given.", str.c_str(), this->eclass->ownGenericArgumentCount, count);
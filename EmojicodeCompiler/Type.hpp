@@ -90,10 +90,13 @@ public:
     
     /** Returns this type as a non-reference type by resolving it on the given type @c o if necessary. */
     Type resolveOn(Type o);
+    /** Resolves a reference to a generic argument of the superclass of @c c on the generic arguments of @c c. */
+    Type resolveOnSuperArguments(Class *c, bool *resolved);
+    /** Returns the storage a list of this type uses, which depends on the type of its elements. */
+    ListStorage listStorage() const;
 private:
     void typeName(Type type, Type parentType, bool includeNsAndOptional, std::string *string) const;
     Type typeConstraintForReference(Class *c);
-    Type resolveOnSuperArguments(Class *c, bool *resolved);
 };
 
 #define typeInteger (Type(TT_INTEGER, false))
@@ -11,66 +11,112 @@
 
 #include "EmojicodeString.h"
 
-/** Default initial capacity. MUST be a power of two, default: 8 */
-#define DICTIONARY_DEFAULT_INITIAL_CAPACITY (1 << 3)
+/**
+ * The number of control bytes that are probed at once. With SSE2 a group is compared with a single instruction.
+ */
+#if defined(__SSE2__)
+#define DICTIONARY_GROUP_WIDTH 16
+#else
+#define DICTIONARY_GROUP_WIDTH 8
+#endif
 
-/** Factor for determining whether the dictionary should be resized. */
-#define DICTIONARY_DEFAULT_LOAD_FACTOR (0.75f)
+/** The capacity of a dictionary’s first slot array. MUST be a power of two and at least the group width. */
+#define DICTIONARY_MINIMUM_CAPACITY 16
 
-#define DICTIONARY_MAXIMUM_CAPACTIY (1 << 30)
+/** A dictionary is resized when more than seven eighths of its slots are full or were deleted. */
+#define dictionaryMaximumLoad(capacity) ((capacity) - (capacity) / 8)
 
-#define DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD (1 << 16)
+#define DICTIONARY_MAXIMUM_CAPACTIY ((size_t)1 << 40)
 
 typedef uint64_t EmojicodeDictionaryHash;
 
-/** The datastructure with the key-value pair */
+/**
+ * Hashes @c length bytes at @c bytes. The hash is seeded with a random value chosen once per process, which makes it
+ * impractical to find keys that collide on purpose.
+ */
+EmojicodeDictionaryHash dictionaryHashBytes(const void *bytes, size_t length);
+
+/** Chooses the random seed used by @c dictionaryHashBytes. Must be called before any key is hashed. */
+void dictionaryInitializeHashSeed(void);
+
+/** A key-value pair stored inline in the slot array of a dictionary. */
 typedef struct {
-    /** The user specified key. */
-    Object *key;
+    /** The user specified key, a string, an integer, a symbol or an object compared by identity. */
+    Something key;
     
     /** The user specified value. */
     Something value;
     
     /** The cached hash for the key. Calculated on item addition. */
     EmojicodeDictionaryHash hash;
-    
-    /** EmojicodeDictionary stores a bucket's elements in a linked list. */
-    Object *next;
-    
-} EmojicodeDictionaryNode;
+} EmojicodeDictionarySlot;
 
-/** Structure for the Emojicode standard Dictionary. The implementation is similar to Java's Hashmap. */
+/**
+ * Structure for the Emojicode standard Dictionary. The implementation is an open-addressing hash table in the style
+ * of Swiss tables: Every slot has a control byte, which is either @c DICTIONARY_EMPTY, @c DICTIONARY_DELETED or the
+ * lowest seven bits of the hash of the slot’s key. Lookups compare a whole group of control bytes at once and only
+ * look at slots whose control byte matches.
+ *
+ * The control bytes and the slots are stored in a single array object, see @c dictionaryControl and
+ * @c dictionarySlots. The first @c DICTIONARY_GROUP_WIDTH control bytes are mirrored behind the last one, so that a
+ * group can be loaded from any position.
+ */
 typedef struct {
-    /** An array with pointers to linked lists. Initializes when the first item is inserted. */
-    Object *buckets;
+    /** The array with the control bytes and slots. Allocated when the first item is inserted. */
+    Object *slots;
     
-    /** Length of buckets array. */
-    size_t bucketsCounter;
+    /** The number of slots, a power of two. */
+    size_t capacity;
     
-    /** The number of items stored in this dictionary. Used for determining whether to resize. */
+    /** The number of items stored in this dictionary. */
     size_t size;
     
-    /** When size * loadFactor >= bucketsCounter the dictionary doubles the amount of buckets */
-    float loadFactor;
-    
-    /** Stores the next threshold for resizing. Is 0 until first resize when item is inserted. */
-    size_t nextThreshold;
+    /** The number of items that can be inserted before the dictionary must be resized. */
+    size_t growthLeft;
 } EmojicodeDictionary;
 
+#define DICTIONARY_EMPTY ((uint8_t)0x80)
+#define DICTIONARY_DELETED ((uint8_t)0xFE)
+
+/** Returns the control bytes of @c dict. @c dict->slots must not be @c NULL. */
+#define dictionaryControl(dict) ((uint8_t *)objectValue((dict)->slots))
+/** Returns the slots of @c dict, which follow the control bytes. @c dict->slots must not be @c NULL. */
+#define dictionarySlots(dict) ((EmojicodeDictionarySlot *)(dictionaryControl(dict) + \
+                               dictionaryControlSize((dict)->capacity)))
+#define dictionaryControlSize(capacity) (((capacity) + DICTIONARY_GROUP_WIDTH + 7) & ~(size_t)7)
+
+/**
+ * The native enumerator of the entries (🎫) or values (💠) of a dictionary. The slots are visited in order, the
+ * enumerator only remembers the index of the next slot to look at.
+ */
+typedef struct {
+    /** The enumerated dictionary. */
+    Object *dictionary;
+    
+    /** The index of the slot at which the search for the next item starts. */
+    size_t index;
+    
+    /** The index of the slot whose item was returned last plus one, or 0 if no item was returned yet. */
+    size_t current;
+} EmojicodeDictionaryEnumerator;
+
 /**
- * Insert an item and use keyString as key 
+ * Insert an item and use @c key as key. Strings are compared by value, integers and symbols by their value and all
+ * other objects by identity.
  * @warning GC-invoking
  */
-void dictionarySet(Object *dicto, Object *key, Something value, Thread *thread);
+void dictionarySet(Object *dicto, Something key, Something value, Thread *thread);
 
-/** Remove an item by keyString as key */
-void dictionaryRemove(EmojicodeDictionary *dict, Object *key, Thread *thread);
+/** Remove an item by @c key as key */
+void dictionaryRemove(EmojicodeDictionary *dict, Something key, Thread *thread);
 
-/** Get an item by keyString as key */
-Something dictionaryLookup(EmojicodeDictionary *dict, Object *key, Thread *thread);
+/** Get an item by @c key as key. Returns @c NOTHINGNESS if there is no item for the key. */
+Something dictionaryLookup(EmojicodeDictionary *dict, Something key, Thread *thread);
 
 void dictionaryMark(Object *dict);
 
+void dictionaryEnumeratorMark(Object *enumerator);
+
 void bridgeDictionaryInit(Thread *thread);
 
 /** @warning GC-invoking */
@@ -78,4 +124,7 @@ void dictionaryInit(Thread *thread);
 
 MethodHandler dictionaryMethodForName(EmojicodeChar name);
 
+/** Returns the handler for the method @c name of the enumerator class @c cl (🎫 or 💠). */
+MethodHandler dictionaryEnumeratorMethodForName(EmojicodeChar cl, EmojicodeChar name);
+
 #endif /* EmojicodeDictionary_h */
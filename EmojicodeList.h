@@ -15,6 +15,11 @@ struct List {
     size_t count;
     size_t capacity;
     Object *items;
+    /**
+     * How the elements in @c items are stored. Lists created with @c newObject store Somethings. A list that stores
+     * its elements unboxed is converted to store Somethings as soon as an element is inserted it cannot hold.
+     */
+    ListStorage storage;
 };
 
 /** 
@@ -33,7 +38,8 @@ Something listPop(List *list);
 bool listRemoveByIndex(List *list, size_t index);
 
 /**
- * Returns the item at @c i or @c NULL if @c i is out of bounds.
+ * Returns the item at @c i or @c NULL if @c i is out of bounds. Items of lists that store their elements unboxed are
+ * wrapped into a Something, which might allocate an integer box.
  */
 Something listGet(List *list, size_t i);
 
@@ -52,6 +58,12 @@ bool listRemove(List *list, Something x);
  */
 void listShuffleInPlace(List *list);
 
+/**
+ * Sorts the list ascending without a comparator. The elements must either all be integers, doubles, symbols, booleans
+ * or strings, which are ordered lexicographically by their code points.
+ */
+void listSort(List *list);
+
 /** Releases list @c l */
 void listRelease(void *l);
 
@@ -9,7 +9,8 @@
 #include <locale.h>
 #include <string.h>
 #include <limits.h>
-#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
 
 #include "Emojicode.h"
 
@@ -27,15 +28,34 @@ Class *CL_ENUMERATOR;
 Class *CL_DICTIONARY;
 Class *CL_CAPTURED_METHOD_CALL;
 Class *CL_CLOSURE;
+Class *CL_DICTIONARY_ENTRY_ENUMERATOR;
+Class *CL_DICTIONARY_VALUE_ENUMERATOR;
 
-//MARK: Coins
+//MARK: Instructions
 
-EmojicodeCoin consumeCoin(Thread *thread){
-    return *(thread->tokenStream++);
+static Instruction consumeInstruction(Thread *thread){
+    return *(thread->instructionPointer++);
+}
+
+static EmojicodeCoin consumeCoin(Thread *thread){
+    return consumeInstruction(thread).coin;
 }
 
 static EmojicodeCoin nextCoin(Thread *thread){
-    return *thread->tokenStream;
+    return thread->instructionPointer->coin;
+}
+
+/** The addresses of the instruction implementations in @c parse, indexed by opcode. */
+static const void *const *instructionHandlers = NULL;
+
+const void* instructionHandler(EmojicodeCoin opcode){
+    if (!instructionHandlers) {
+        parse(NULL);
+    }
+    if (opcode > 0xFF || !instructionHandlers[opcode]) {
+        return instructionHandlers[0];
+    }
+    return instructionHandlers[opcode];
 }
 
 //MARK: Error
@@ -56,8 +76,7 @@ _Noreturn void error(char *err, ...){
 //MARK: Block utilities
 
 static void passBlock(Thread *thread){
-    EmojicodeCoin length = consumeCoin(thread);
-    thread->tokenStream += length; //This coin only contains the length of the block
+    thread->instructionPointer = consumeInstruction(thread).target; //This cell contains the end of the block
 }
 
 /** 
@@ -66,11 +85,10 @@ static void passBlock(Thread *thread){
  * Every other block ran by runBlock will also automatically respond.
  */
 static bool runBlock(Thread *thread){
-    EmojicodeCoin length = consumeCoin(thread); //This token only contains the length of the block
+    Instruction *end = consumeInstruction(thread).target; //This cell only contains the end of the block
     
-    EmojicodeCoin *end = thread->tokenStream + length;
-    while (thread->tokenStream < end) {
-        parse(consumeCoin(thread), thread);
+    while (thread->instructionPointer < end) {
+        parse(thread);
         
         if(thread->returned){
             return true;
@@ -81,11 +99,9 @@ static bool runBlock(Thread *thread){
 }
 
 static Something runFunctionBlock(Thread *thread, uint32_t length){
-    EmojicodeCoin *end = thread->tokenStream + length;
-    while (thread->tokenStream < end) {
-        EmojicodeCoin c = consumeCoin(thread);
-
-        parse(c, thread);
+    Instruction *end = thread->instructionPointer + length;
+    while (thread->instructionPointer < end) {
+        parse(thread);
         
         if(thread->returned){
             Something ret = thread->returnValue;
@@ -96,39 +112,109 @@ static Something runFunctionBlock(Thread *thread, uint32_t length){
     return NOTHINGNESS;
 }
 
+/**
+ * Runs the instructions of a method or class method, whose stack frame must already have been pushed. If the JIT
+ * compiled the procedure its native code is run instead.
+ */
+static Something runProcedure(Instruction *instructions, uint32_t instructionCount, JITState *jit, Thread *thread){
+    pollSafepoint(thread);
+    if (jit->code || (jitEnabled && jitTierUp(jit, instructions, instructionCount))) {
+        return jit->code(stackVariables(thread));
+    }
+    
+    Instruction *preInstructionPointer = thread->instructionPointer;
+    
+    thread->instructionPointer = instructions;
+    
+    Something ret = runFunctionBlock(thread, instructionCount);
+    
+    thread->instructionPointer = preInstructionPointer;
+    return ret;
+}
+
 static Class* readClass(Thread *thread) {
-    EmojicodeCoin classIndex = consumeCoin(thread);
+    Class *class = consumeInstruction(thread).class;
     
-    if(classIndex == UINT32_MAX){
+    if(class == NULL){
         return stackGetThisClass(thread);
     }
     
-    return classTable[classIndex];
+    return class;
 }
 
-static double readDouble(Thread *thread) {
-    EmojicodeInteger scale = ((EmojicodeInteger)consumeCoin(thread) << 32) ^ consumeCoin(thread);
-    EmojicodeInteger exp = consumeCoin(thread);
-    
-    return ldexp((double)scale/PORTABLE_INTLEAST64_MAX, (int)exp);
+//MARK: Inline caches
+
+bool inlineCacheStatisticsEnabled = false;
+//The counters are shared by all threads. They are only touched if enabled, as they bounce between the cores.
+uint64_t inlineCacheHits = 0;
+uint64_t inlineCacheMisses = 0;
+
+/** Returns the method cached for @c class or @c NULL if the call site has not seen this class yet. */
+static Method* inlineCacheLookup(InlineCache *cache, Class *class){
+    uint_fast8_t count = __atomic_load_n(&cache->count, __ATOMIC_ACQUIRE);
+    for (uint_fast8_t i = 0; i < count; i++) {
+        if (cache->classes[i] == class) {
+            if (inlineCacheStatisticsEnabled) {
+                __atomic_fetch_add(&inlineCacheHits, 1, __ATOMIC_RELAXED);
+            }
+            return cache->methods[i];
+        }
+    }
+    if (inlineCacheStatisticsEnabled) {
+        __atomic_fetch_add(&inlineCacheMisses, 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
 }
 
+/**
+ * Remembers @c method for @c class unless the call site is already megamorphic. If another thread is storing an entry
+ * at the same call site, nothing is stored, the next miss tries again.
+ */
+static void inlineCacheStore(InlineCache *cache, Class *class, Method *method){
+    if (__atomic_load_n(&cache->count, __ATOMIC_ACQUIRE) == inlineCacheSize ||
+        __atomic_test_and_set(&cache->storing, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    uint8_t count = cache->count;
+    //Another thread might have stored the class since the lookup
+    for (uint8_t i = 0; i < count; i++) {
+        if (cache->classes[i] == class) {
+            __atomic_clear(&cache->storing, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+    if (count < inlineCacheSize) {
+        cache->classes[count] = class;
+        cache->methods[count] = method;
+        __atomic_store_n(&cache->count, count + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_clear(&cache->storing, __ATOMIC_RELEASE);
+}
+
+void reportInlineCacheStatistics(){
+    uint64_t hits = __atomic_load_n(&inlineCacheHits, __ATOMIC_RELAXED);
+    uint64_t misses = __atomic_load_n(&inlineCacheMisses, __ATOMIC_RELAXED);
+    uint64_t calls = hits + misses;
+    double rate = calls ? 100.0 / calls : 0;
+    fprintf(stderr, "Inline caches: %" PRIu64 " calls, %" PRIu64 " hits (%.2f%%), %" PRIu64 " misses (%.2f%%)\n",
+            calls, hits, hits * rate, misses, misses * rate);
+}
 
 //MARK:
 
 bool isNothingness(Something sth){
-    return sth.type == T_OBJECT && sth.object == NULL;
+    return sth.bits == 0;
 }
 
 bool isRealObject(Something sth){
-    return sth.type == T_OBJECT && sth.object;
+    return sth.bits != 0 && isEncodedObject(sth);
 }
 
 //MARK: Low level parsing
 
 Something executeCallableExtern(Object *callable, Something *args, Thread *thread){
     if (callable->class == CL_CAPTURED_METHOD_CALL) {
-        CapturedMethodCall *cmc = callable->value;
+        CapturedMethodCall *cmc = objectValue(callable);
         Method *method = cmc->method;
         Object *object = cmc->object;
         
@@ -144,33 +230,32 @@ Something executeCallableExtern(Object *callable, Something *args, Thread *threa
             memcpy(t, args, method->argumentCount * sizeof(Something));
             stackPushReservedFrame(thread);
             
-            EmojicodeCoin *preCoinStream = thread->tokenStream;
-            
-            thread->tokenStream = method->tokenStream;
-            
-            ret = runFunctionBlock(thread, method->tokenCount);
-            
-            thread->tokenStream = preCoinStream;
+            ret = runProcedure(method->instructions, method->instructionCount, &method->jit, thread);
         }
         stackPop(thread);
         return ret;
     }
     else {
-        Closure *c = stackGetThis(thread)->value;
+        Closure *c = objectValue(callable);
         
         Something *t = stackReserveFrame(c->this, c->variableCount, thread);
         memcpy(t, args, c->argumentCount * sizeof(Something));
         stackPushReservedFrame(thread);
         
-        Something *cv = c->capturedVariables->value;
+        Something *cv = objectValue(c->capturedVariables);
         for (uint8_t i = 0; i < c->capturedVariablesCount; i++) {
             stackSetVariable(c->argumentCount + i, cv[i], thread);
         }
         
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
-        thread->tokenStream = c->tokenStream;
-        Something ret = runFunctionBlock(thread, c->coinCount);
-        thread->tokenStream = preCoinStream;
+        //The closure might be moved at the safepoint
+        Instruction *instructions = c->instructions;
+        uint32_t instructionCount = c->instructionCount;
+        pollSafepoint(thread);
+        
+        Instruction *preInstructionPointer = thread->instructionPointer;
+        thread->instructionPointer = instructions;
+        Something ret = runFunctionBlock(thread, instructionCount);
+        thread->instructionPointer = preInstructionPointer;
         
         stackPop(thread);
         return ret;
@@ -186,29 +271,31 @@ Something performInitializer(Class *class, Initializer *initializer, Object *obj
         stackPush(object, initializer->argumentCount, initializer->argumentCount, thread);
         initializer->handler(thread);
         
-        if(object->value == NULL){
+        object = stackGetThis(thread);
+        if(object == NULL){
             stackPop(thread);
             return NOTHINGNESS;
         }
     }
     else {
         stackPush(object, initializer->variableCount, initializer->argumentCount, thread);
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
+        Instruction *preInstructionPointer = thread->instructionPointer;
         
-        thread->tokenStream = initializer->tokenStream;
+        thread->instructionPointer = initializer->instructions;
         
-        EmojicodeCoin *end = thread->tokenStream + initializer->tokenCount;
-        while (thread->tokenStream < end) {
-            parse(consumeCoin(thread), thread);
+        Instruction *end = thread->instructionPointer + initializer->instructionCount;
+        while (thread->instructionPointer < end) {
+            parse(thread);
             
             if(thread->returned){
-                thread->tokenStream = preCoinStream;
+                thread->instructionPointer = preInstructionPointer;
                 stackPop(thread);
                 return NOTHINGNESS;
             }
         }
         
-        thread->tokenStream = preCoinStream;
+        thread->instructionPointer = preInstructionPointer;
+        object = stackGetThis(thread);
     }
     stackPop(thread);
 
@@ -223,14 +310,7 @@ Something performMethod(Method *method, Object *object, Thread *thread){
     }
     else {
         stackPush(object, method->variableCount, method->argumentCount, thread);
-        
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
-        
-        thread->tokenStream = method->tokenStream;
-        
-        ret = runFunctionBlock(thread, method->tokenCount);
-        
-        thread->tokenStream = preCoinStream;
+        ret = runProcedure(method->instructions, method->instructionCount, &method->jit, thread);
     }
     stackPop(thread);
     
@@ -245,13 +325,7 @@ Something performClassMethod(ClassMethod *method, Class *class, Thread *thread){
     }
     else {
         stackPush(class, method->variableCount, method->argumentCount, thread);
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
-        
-        thread->tokenStream = method->tokenStream;
-        
-        ret = runFunctionBlock(thread, method->tokenCount);
-        
-        thread->tokenStream = preCoinStream;
+        ret = runProcedure(method->instructions, method->instructionCount, &method->jit, thread);
     }
     stackPop(thread);
     
@@ -259,561 +333,726 @@ Something performClassMethod(ClassMethod *method, Class *class, Thread *thread){
 }
 
 
-Something parse(EmojicodeCoin coin, Thread *thread){
-    switch (coin) {
-        case 0x1: {
-            Object *object = parse(consumeCoin(thread), thread).object;
-            
-            EmojicodeCoin vti = consumeCoin(thread);
-            Method *method = object->class->methodsVtable[vti];
-            
-            return performMethod(method, object, thread);
-        }
-        case 0x2: { //donut – class method
-            Class *class = readClass(thread);
-            
-            EmojicodeCoin vti = consumeCoin(thread);
-            ClassMethod *method = class->classMethodsVtable[vti];
-            
-            return performClassMethod(method, class, thread);
-        }
-        case 0x3: {
-            Object *object = parse(consumeCoin(thread), thread).object;
-            
-            EmojicodeCoin pti = consumeCoin(thread);
-            EmojicodeCoin vti = consumeCoin(thread);
-            
-            Method *method = object->class->protocolsTable[pti - object->class->protocolsOffset][vti];
-            return performMethod(method, object, thread);
-        }
-        case 0x4: { //New Object
-            Class *class = readClass(thread);
-            
-            Initializer *initializer = class->initializersVtable[consumeCoin(thread)];
-            return performInitializer(class, initializer, NULL, thread);
-        }
-        case 0x5: {
-            Class *class = readClass(thread);
-            EmojicodeCoin vti = consumeCoin(thread);
-            Method *method = class->methodsVtable[vti];
-            
-            return performMethod(method, stackGetThis(thread), thread);
+#define INSTRUCTION(opcode) instruction ## opcode
+
+Something parse(Thread *thread){
+    static const void *const handlers[0x100] = {
+        [0] = &&instructionUnknown,
+        [0x1] = &&INSTRUCTION(0x1),
+        [0x2] = &&INSTRUCTION(0x2),
+        [0x3] = &&INSTRUCTION(0x3),
+        [0x4] = &&INSTRUCTION(0x4),
+        [0x5] = &&INSTRUCTION(0x5),
+        [0x10] = &&INSTRUCTION(0x10),
+        [0x11] = &&INSTRUCTION(0x11),
+        [0x12] = &&INSTRUCTION(0x12),
+        [0x13] = &&INSTRUCTION(0x13),
+        [0x15] = &&INSTRUCTION(0x15),
+        [0x16] = &&INSTRUCTION(0x16),
+        [0x17] = &&INSTRUCTION(0x17),
+        [0x18] = &&INSTRUCTION(0x18),
+        [0x19] = &&INSTRUCTION(0x19),
+        [0x1A] = &&INSTRUCTION(0x1A),
+        [0x1B] = &&INSTRUCTION(0x1B),
+        [0x1C] = &&INSTRUCTION(0x1C),
+        [0x1D] = &&INSTRUCTION(0x1D),
+        [0x1E] = &&INSTRUCTION(0x1E),
+        [0x1F] = &&INSTRUCTION(0x1F),
+        [0x20] = &&INSTRUCTION(0x20),
+        [0x21] = &&INSTRUCTION(0x21),
+        [0x22] = &&INSTRUCTION(0x22),
+        [0x23] = &&INSTRUCTION(0x23),
+        [0x24] = &&INSTRUCTION(0x24),
+        [0x25] = &&INSTRUCTION(0x25),
+        [0x26] = &&INSTRUCTION(0x26),
+        [0x27] = &&INSTRUCTION(0x27),
+        [0x28] = &&INSTRUCTION(0x28),
+        [0x29] = &&INSTRUCTION(0x29),
+        [0x2A] = &&INSTRUCTION(0x2A),
+        [0x2B] = &&INSTRUCTION(0x2B),
+        [0x2C] = &&INSTRUCTION(0x2C),
+        [0x2D] = &&INSTRUCTION(0x2D),
+        [0x2E] = &&INSTRUCTION(0x2E),
+        [0x2F] = &&INSTRUCTION(0x2F),
+        [0x30] = &&INSTRUCTION(0x30),
+        [0x31] = &&INSTRUCTION(0x31),
+        [0x32] = &&INSTRUCTION(0x32),
+        [0x33] = &&INSTRUCTION(0x33),
+        [0x34] = &&INSTRUCTION(0x34),
+        [0x35] = &&INSTRUCTION(0x35),
+        [0x36] = &&INSTRUCTION(0x36),
+        [0x37] = &&INSTRUCTION(0x37),
+        [0x3A] = &&INSTRUCTION(0x3A),
+        [0x3B] = &&INSTRUCTION(0x3B),
+        [0x3C] = &&INSTRUCTION(0x3C),
+        [0x3D] = &&INSTRUCTION(0x3D),
+        [0x3E] = &&INSTRUCTION(0x3E),
+        [0x40] = &&INSTRUCTION(0x40),
+        [0x41] = &&INSTRUCTION(0x41),
+        [0x42] = &&INSTRUCTION(0x42),
+        [0x43] = &&INSTRUCTION(0x43),
+        [0x44] = &&INSTRUCTION(0x44),
+        [0x45] = &&INSTRUCTION(0x45),
+        [0x46] = &&INSTRUCTION(0x46),
+        [0x47] = &&INSTRUCTION(0x47),
+        [0x50] = &&INSTRUCTION(0x50),
+        [0x51] = &&INSTRUCTION(0x51),
+        [0x52] = &&INSTRUCTION(0x52),
+        [0x60] = &&INSTRUCTION(0x60),
+        [0x61] = &&INSTRUCTION(0x61),
+        [0x62] = &&INSTRUCTION(0x62),
+        [0x64] = &&INSTRUCTION(0x64),
+        [0x65] = &&INSTRUCTION(0x65),
+        [0x67] = &&INSTRUCTION(0x67),
+        [0x70] = &&INSTRUCTION(0x70),
+        [0x71] = &&INSTRUCTION(0x71),
+        [0x72] = &&INSTRUCTION(0x72),
+    };
+    
+    if (!thread) { //Only the handler addresses are requested
+        instructionHandlers = handlers;
+        return NOTHINGNESS;
+    }
+    
+    goto *consumeInstruction(thread).handler;
+    
+    instructionUnknown:
+        return NOTHINGNESS;
+    INSTRUCTION(0x1): {
+        Object *object = parse(thread).object;
+        
+        EmojicodeCoin vti = consumeCoin(thread);
+        InlineCache *cache = consumeInstruction(thread).cache;
+        Method *method = inlineCacheLookup(cache, object->class);
+        if (!method) {
+            method = object->class->methodsVtable[vti];
+            inlineCacheStore(cache, object->class, method);
         }
-        case 0x10:
-            return somethingObject(stringPool[consumeCoin(thread)]);
-        case 0x11:
-            return EMOJICODE_TRUE;
-        case 0x12:
-            return EMOJICODE_FALSE;
-        case 0x13:
-            return somethingInteger((EmojicodeInteger)(int)consumeCoin(thread));
-        case 0x14:
-            return somethingInteger((EmojicodeInteger)consumeCoin(thread) << 32 | consumeCoin(thread));
-        case 0x15:
-            return somethingDouble(readDouble(thread));
-        case 0x16:
-            return somethingSymbol((EmojicodeChar)consumeCoin(thread));
-        case 0x17:
-            return NOTHINGNESS;
-        case 0x18: {
-            EmojicodeCoin index = consumeCoin(thread);
-            stackIncrementVariable(index, thread);
-            return NOTHINGNESS;
+        
+        return performMethod(method, object, thread);
+    }
+    INSTRUCTION(0x2): { //donut – class method
+        Class *class = readClass(thread);
+        
+        EmojicodeCoin vti = consumeCoin(thread);
+        ClassMethod *method = class->classMethodsVtable[vti];
+        
+        return performClassMethod(method, class, thread);
+    }
+    INSTRUCTION(0x3): {
+        Object *object = parse(thread).object;
+        
+        EmojicodeCoin pti = consumeCoin(thread);
+        EmojicodeCoin vti = consumeCoin(thread);
+        InlineCache *cache = consumeInstruction(thread).cache;
+        
+        Method *method = inlineCacheLookup(cache, object->class);
+        if (!method) {
+            method = object->class->protocolsTable[pti - object->class->protocolsOffset][vti];
+            inlineCacheStore(cache, object->class, method);
         }
-        case 0x19: {
-            EmojicodeCoin index = consumeCoin(thread);
-            stackDecrementVariable(index, thread);
-            return NOTHINGNESS;
+        return performMethod(method, object, thread);
+    }
+    INSTRUCTION(0x4): { //New Object
+        Class *class = readClass(thread);
+        
+        Initializer *initializer = class->initializersVtable[consumeCoin(thread)];
+        return performInitializer(class, initializer, NULL, thread);
+    }
+    INSTRUCTION(0x5): {
+        Class *class = readClass(thread);
+        EmojicodeCoin vti = consumeCoin(thread);
+        Method *method = class->methodsVtable[vti];
+        
+        return performMethod(method, stackGetThis(thread), thread);
+    }
+    INSTRUCTION(0x10):
+        return somethingObject(*consumeInstruction(thread).string);
+    INSTRUCTION(0x11):
+        return EMOJICODE_TRUE;
+    INSTRUCTION(0x12):
+        return EMOJICODE_FALSE;
+    INSTRUCTION(0x13):
+        return somethingInteger(consumeInstruction(thread).integer);
+    INSTRUCTION(0x15):
+        return somethingDouble(consumeInstruction(thread).doubl);
+    INSTRUCTION(0x16):
+        return somethingSymbol((EmojicodeChar)consumeCoin(thread));
+    INSTRUCTION(0x17):
+        return NOTHINGNESS;
+    INSTRUCTION(0x18): {
+        EmojicodeCoin index = consumeCoin(thread);
+        stackIncrementVariable(index, thread);
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x19): {
+        EmojicodeCoin index = consumeCoin(thread);
+        stackDecrementVariable(index, thread);
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x1A): {
+        EmojicodeCoin index = consumeCoin(thread);
+        return stackGetVariable(index, thread);
+    }
+    INSTRUCTION(0x1B): {
+        EmojicodeCoin index = consumeCoin(thread);
+        stackSetVariable(index, parse(thread), thread);
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x1C): {
+        EmojicodeCoin index = consumeCoin(thread);
+        return objectGetVariable(stackGetThis(thread), index);
+    }
+    INSTRUCTION(0x1D): {
+        EmojicodeCoin index = consumeCoin(thread);
+        objectSetVariable(stackGetThis(thread), index, parse(thread));
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x1E): {
+        EmojicodeCoin index = consumeCoin(thread);
+        objectIncrementVariable(stackGetThis(thread), index);
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x1F): {
+        EmojicodeCoin index = consumeCoin(thread);
+        objectDecrementVariable(stackGetThis(thread), index);
+        return NOTHINGNESS;
+    }
+    //Operators
+    INSTRUCTION(0x20): {
+        Something a = parse(thread);
+        //An integer box might move while the second operand is evaluated
+        if (isRealObject(a)) {
+            EmojicodeInteger i = unboxInteger(a.object);
+            return somethingBoolean(i == unwrapInteger(parse(thread)));
         }
-        case 0x1A: {
-            EmojicodeCoin index = consumeCoin(thread);
-            return stackGetVariable(index, thread);
+        return somethingBoolean(a.bits == parse(thread).bits);
+    }
+    INSTRUCTION(0x21): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingInteger(a - unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x22): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingInteger(a + unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x23): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingInteger(a * unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x24): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingInteger(a / unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x25): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingInteger(a % unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x26): //Invert
+        return !unwrapBool(parse(thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    INSTRUCTION(0x27): {
+        Something a = parse(thread);
+        Something b = parse(thread);
+        return unwrapBool(a) || unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    }
+    INSTRUCTION(0x28): {
+        Something a = parse(thread);
+        Something b = parse(thread);
+        return unwrapBool(a) && unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    }
+    //MARK: Integers
+    INSTRUCTION(0x29): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingBoolean(a < unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x2A): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingBoolean(a > unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x2B): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingBoolean(a <= unwrapInteger(parse(thread)));
+    }
+    INSTRUCTION(0x2C): {
+        EmojicodeInteger a = unwrapInteger(parse(thread));
+        return somethingBoolean(a >= unwrapInteger(parse(thread)));
+    }
+    //MARK: General Comparisons
+    INSTRUCTION(0x2D): {
+        Object *a = parse(thread).object;
+        return somethingBoolean(a == parse(thread).object);
+    }
+    INSTRUCTION(0x2E):
+        return isNothingness(parse(thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    //MARK: Floats
+    INSTRUCTION(0x2F): {
+        double a = unwrapDouble(parse(thread));
+        return somethingBoolean(a == unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x30): {
+        double a = unwrapDouble(parse(thread));
+        return somethingDouble(a - unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x31): {
+        double a = unwrapDouble(parse(thread));
+        return somethingDouble(a + unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x32): {
+        double a = unwrapDouble(parse(thread));
+        return somethingDouble(a * unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x33): {
+        double a = unwrapDouble(parse(thread));
+        return somethingDouble(a / unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x34): {
+        double a = unwrapDouble(parse(thread));
+        return somethingBoolean(a < unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x35): {
+        double a = unwrapDouble(parse(thread));
+        return somethingBoolean(a > unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x36): {
+        double a = unwrapDouble(parse(thread));
+        return somethingBoolean(a <= unwrapDouble(parse(thread)));
+    }
+    INSTRUCTION(0x37): {
+        double a = unwrapDouble(parse(thread));
+        return somethingBoolean(a >= unwrapDouble(parse(thread)));
+    }
+    //MARK: Optionals
+    INSTRUCTION(0x3A): {
+        Something sth = parse(thread);
+        
+        if(isNothingness(sth)){
+            error("Unexpectedly found ✨ while unwrapping a 🍬.");
         }
-        case 0x1B: {
-            EmojicodeCoin index = consumeCoin(thread);
-            stackSetVariable(index, parse(consumeCoin(thread), thread), thread);
+        
+        return sth;
+    }
+    INSTRUCTION(0x3B): {
+        Instruction *end = consumeInstruction(thread).target;
+        Something sth = parse(thread);
+        EmojicodeCoin vti = consumeCoin(thread);
+        InlineCache *cache = consumeInstruction(thread).cache;
+        
+        if(isNothingness(sth)){
+            thread->instructionPointer = end;
             return NOTHINGNESS;
         }
-        case 0x1C: {
-            EmojicodeCoin index = consumeCoin(thread);
-            return objectGetVariable(stackGetThis(thread), index);
-        }
-        case 0x1D: {
-            EmojicodeCoin index = consumeCoin(thread);
-            objectSetVariable(stackGetThis(thread), index, parse(consumeCoin(thread), thread));
-            return NOTHINGNESS;
+        
+        Object *object = sth.object;
+        Method *method = inlineCacheLookup(cache, object->class);
+        if (!method) {
+            method = object->class->methodsVtable[vti];
+            inlineCacheStore(cache, object->class, method);
         }
-        case 0x1E: {
-            EmojicodeCoin index = consumeCoin(thread);
-            objectIncrementVariable(stackGetThis(thread), index);
-            return NOTHINGNESS;
+        
+        return performMethod(method, object, thread);
+    }
+    //MARK: Object Orientation Utility
+    INSTRUCTION(0x3C):
+        return somethingObject(stackGetThis(thread));
+    INSTRUCTION(0x3D): {
+        Object *o = stackGetThis(thread);
+        
+        Class *class = readClass(thread);
+        
+        EmojicodeCoin vti = consumeCoin(thread);
+        Initializer *initializer = class->initializersVtable[vti];
+        
+        performInitializer(class, initializer, o, thread);
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x3E): {
+        EmojicodeCoin index = consumeCoin(thread);
+        Something sth = parse(thread);
+        if (isNothingness(sth)) {
+            return EMOJICODE_FALSE;
         }
-        case 0x1F: {
-            EmojicodeCoin index = consumeCoin(thread);
-            objectDecrementVariable(stackGetThis(thread), index);
-            return NOTHINGNESS;
+        else {
+            stackSetVariable(index, sth, thread);
+            return EMOJICODE_TRUE;
         }
-        //Operators
-        case 0x20:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw == parse(consumeCoin(thread), thread).raw);
-        case 0x21:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw - parse(consumeCoin(thread), thread).raw);
-        case 0x22:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw + parse(consumeCoin(thread), thread).raw);
-        case 0x23:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw * parse(consumeCoin(thread), thread).raw);
-        case 0x24:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw / parse(consumeCoin(thread), thread).raw);
-        case 0x25:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw % parse(consumeCoin(thread), thread).raw);
-        case 0x26: //Invert
-            return !unwrapBool(parse(consumeCoin(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
-        case 0x27: {
-            Something a = parse(consumeCoin(thread), thread);
-            Something b = parse(consumeCoin(thread), thread);
-            return unwrapBool(a) || unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
-        }
-        case 0x28: {
-            Something a = parse(consumeCoin(thread), thread);
-            Something b = parse(consumeCoin(thread), thread);
-            return unwrapBool(a) && unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
-        }
-        //MARK: Integers
-        case 0x29:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw < parse(consumeCoin(thread), thread).raw);
-        case 0x2A:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw > parse(consumeCoin(thread), thread).raw);
-        case 0x2B:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw <= parse(consumeCoin(thread), thread).raw);
-        case 0x2C:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw >= parse(consumeCoin(thread), thread).raw);
-        //MARK: General Comparisons
-        case 0x2D:
-            return somethingBoolean(parse(consumeCoin(thread), thread).object == parse(consumeCoin(thread), thread).object);
-        case 0x2E:
-            return isNothingness(parse(consumeCoin(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
-        //MARK: Floats
-        case 0x2F:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl == parse(consumeCoin(thread), thread).doubl);
-        case 0x30:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl - parse(consumeCoin(thread), thread).doubl);
-        case 0x31:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl + parse(consumeCoin(thread), thread).doubl);
-        case 0x32:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl * parse(consumeCoin(thread), thread).doubl);
-        case 0x33:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl / parse(consumeCoin(thread), thread).doubl);
-        case 0x34:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl < parse(consumeCoin(thread), thread).doubl);
-        case 0x35:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl > parse(consumeCoin(thread), thread).doubl);
-        case 0x36:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl <= parse(consumeCoin(thread), thread).doubl);
-        case 0x37:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl >= parse(consumeCoin(thread), thread).doubl);
-        //MARK: Optionals
-        case 0x3A: {
-            Something sth = parse(consumeCoin(thread), thread);
-            
-            if(isNothingness(sth)){
-                error("Unexpectedly found ✨ while unwrapping a 🍬.");
-            }
-            
+    }
+    //MARK: Casts
+    INSTRUCTION(0x40): {
+        Something sth = parse(thread);
+        Class *class = readClass(thread);
+        if(isRealObject(sth) && instanceof(sth.object, class)){
             return sth;
         }
-        case 0x3B: {
-            EmojicodeCoin count = consumeCoin(thread);
-            Something sth = parse(consumeCoin(thread), thread);
-            EmojicodeCoin vti = consumeCoin(thread);
-            
-            if(isNothingness(sth)){
-                thread->tokenStream += count;
-                return NOTHINGNESS;
-            }
-            
-            Method *method = sth.object->class->methodsVtable[vti];
-            Object *object = sth.object;
-            
-            return performMethod(method, object, thread);
-        }
-        //MARK: Object Orientation Utility
-        case 0x3C:
-            return somethingObject(stackGetThis(thread));
-        case 0x3D: {
-            Object *o = stackGetThis(thread);
-            
-            Class *class = readClass(thread);
-            
-            EmojicodeCoin vti = consumeCoin(thread);
-            Initializer *initializer = class->initializersVtable[vti];
-            
-            performInitializer(class, initializer, o, thread);
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x41): {
+        Something sth = parse(thread);
+        EmojicodeCoin pi = consumeCoin(thread);
+        if(isRealObject(sth) && conformsTo(sth.object->class, pi)){
+            return sth;
         }
-        case 0x3E: {
-            EmojicodeCoin index = consumeCoin(thread);
-            Something sth = parse(consumeCoin(thread), thread);
-            if (isNothingness(sth)) {
-                return EMOJICODE_FALSE;
-            }
-            else {
-                stackSetVariable(index, sth, thread);
-                return EMOJICODE_TRUE;
-            }
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x42): {
+        Something sth = parse(thread);
+        if(somethingType(sth) == T_BOOLEAN){
+            return sth;
         }
-        //MARK: Casts
-        case 0x40: {
-            Something sth = parse(consumeCoin(thread), thread);
-            Class *class = readClass(thread);
-            if(sth.type == T_OBJECT && instanceof(sth.object, class)){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x43): {
+        Something sth = parse(thread);
+        if(somethingType(sth) == T_INTEGER){
+            return sth;
         }
-        case 0x41: {
-            Something sth = parse(consumeCoin(thread), thread);
-            EmojicodeCoin pi = consumeCoin(thread);
-            if(sth.type == T_OBJECT && conformsTo(sth.object->class, pi)){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x44): {
+        Something sth = parse(thread);
+        Class *class = readClass(thread);
+        if(isRealObject(sth) && instanceof(sth.object, class)){
+            return sth;
         }
-        case 0x42: {
-            Something sth = parse(consumeCoin(thread), thread);
-            if(sth.type == T_BOOLEAN){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x45): {
+        Something sth = parse(thread);
+        EmojicodeCoin pi = consumeCoin(thread);
+        if(isRealObject(sth) && conformsTo(sth.object->class, pi)){
+            return sth;
         }
-        case 0x43: {
-            Something sth = parse(consumeCoin(thread), thread);
-            if(sth.type == T_INTEGER){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x46): {
+        Something sth = parse(thread);
+        if(somethingType(sth) == T_SYMBOL){
+            return sth;
         }
-        case 0x44: {
-            Something sth = parse(consumeCoin(thread), thread);
-            Class *class = readClass(thread);
-            if(sth.type == T_OBJECT && !isNothingness(sth) && instanceof(sth.object, class)){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x47): {
+        Something sth = parse(thread);
+        if(somethingType(sth) == T_DOUBLE){
+            return sth;
         }
-        case 0x45: {
-            Something sth = parse(consumeCoin(thread), thread);
-            EmojicodeCoin pi = consumeCoin(thread);
-            if(sth.type == T_OBJECT && !isNothingness(sth) && conformsTo(sth.object->class, pi)){
-                return sth;
-            }
+        
+        return NOTHINGNESS;
+    }
+    //MARK: Literals
+    INSTRUCTION(0x50): {
+        stackPush(newObject(CL_DICTIONARY), 1, 0, thread);
+        dictionaryInit(thread);
+        
+        Instruction *end = consumeInstruction(thread).target;
+        while (thread->instructionPointer < end){
+            stackSetVariable(0, parse(thread), thread);
+            Something sth = parse(thread);
             
-            return NOTHINGNESS;
+            dictionarySet(stackGetThis(thread), stackGetVariable(0, thread), sth, thread);
         }
-        case 0x46: {
-            Something sth = parse(consumeCoin(thread), thread);
-            if(sth.type == T_SYMBOL){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        Object *dict = stackGetThis(thread);
+        stackPop(thread);
+        
+        return somethingObject(dict);
+    }
+    INSTRUCTION(0x51): {
+        Something *t = stackReserveFrame(NULL, 1, thread);
+        
+        t[0] = somethingObject(newObject(CL_LIST));
+        ((List *)objectValue(t[0].object))->storage = consumeCoin(thread);
+        
+        Instruction *end = consumeInstruction(thread).target;
+        while (thread->instructionPointer < end){
+            listAppend(t[0].object, parse(thread), thread);
         }
-        case 0x47: {
-            Something sth = parse(consumeCoin(thread), thread);
-            if(sth.type == T_DOUBLE){
-                return sth;
-            }
-            
-            return NOTHINGNESS;
+        
+        Something sth = t[0];
+        
+        stackPushReservedFrame(thread);
+        stackPop(thread);
+        
+        return sth;
+    }
+    INSTRUCTION(0x52): {
+        EmojicodeCoin stringCount = consumeCoin(thread);
+        Something *t = stackReserveFrame(NULL, stringCount + 1, thread);
+        
+        EmojicodeInteger length = 0;
+        bool compact = true;
+        
+        for (EmojicodeCoin i = 0; i < stringCount; i++) {
+            Something sm = parse(thread);
+            t[i] = sm;
+            String *string = objectValue(sm.object);
+            length += string->length;
+            compact = compact && string->compact;
         }
-        //MARK: Literals
-        case 0x50: {
-            stackPush(newObject(CL_DICTIONARY), 0, 0, thread);
-            dictionaryInit(thread);
-            
-            EmojicodeCoin *end = thread->tokenStream + consumeCoin(thread);
-            while (thread->tokenStream < end){
-                Object *key = parse(consumeCoin(thread), thread).object;
-                Something sth = parse(consumeCoin(thread), thread);
-                
-                dictionarySet(stackGetThis(thread), key, sth, thread);
-            }
-            
-            Object *dict = stackGetThis(thread);
-            stackPop(thread);
-            
-            return somethingObject(dict);
+        
+        stackPushReservedFrame(thread);
+        
+        Object *object = newObject(CL_STRING);
+        
+        stackSetVariable(stringCount, somethingObject(object), thread);
+        
+        Object *characters = newArray(stringStorageSize(length, compact));
+        
+        Something sm = stackGetVariable(stringCount, thread);
+        String *string = objectValue(sm.object);
+        string->length = length;
+        string->characters = characters;
+        string->compact = compact;
+        writeBarrier(sm.object, somethingObject(characters));
+        
+        size_t offset = 0;
+        for (int i = 0; i < stringCount; i++) {
+            String *part = objectValue(stackGetVariable(i, thread).object);
+            stringCopyCharacters(string, offset, part);
+            offset += part->length;
         }
-        case 0x51: {
-            Something *t = stackReserveFrame(NULL, 1, thread);
-            
-            t[0] = somethingObject(newObject(CL_LIST));
-            
-            EmojicodeCoin *end = thread->tokenStream + consumeCoin(thread);
-            while (thread->tokenStream < end){
-                listAppend(t[0].object, parse(consumeCoin(thread), thread), thread);
+        
+        stackPop(thread);
+        
+        return sm;
+    }
+    //MARK: Flow Control
+    INSTRUCTION(0x60): { //Red apple - return
+        thread->returnValue = parse(thread);
+        thread->returned = true;
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x61): { //MARK: cherries
+        uint32_t *hotness = consumeInstruction(thread).counter;
+        Instruction *beginPosition = thread->instructionPointer;
+        while (unwrapBool(parse(thread))) {
+            if(runBlock(thread)) {
+                return NOTHINGNESS;
             }
-            
-            Something sth = t[0];
-            
-            stackPushReservedFrame(thread);
-            stackPop(thread);
-            
-            return sth;
+            (*hotness)++;
+            pollSafepoint(thread);
+            thread->instructionPointer = beginPosition;
         }
-        case 0x52: {
-            EmojicodeCoin stringCount = consumeCoin(thread);
-            Something *t = stackReserveFrame(NULL, stringCount + 1, thread);
-            
-            EmojicodeInteger length = 0;
-            
-            for (EmojicodeCoin i = 0; i < stringCount; i++) {
-                Something sm = parse(consumeCoin(thread), thread);
-                t[i] = sm;
-                String *string = sm.object->value;
-                length += string->length;
-            }
-            
-            stackPushReservedFrame(thread);
-            
-            Object *object = newObject(CL_STRING);
-            
-            stackSetVariable(stringCount, somethingObject(object), thread);
-            
-            Object *characters = newArray(length * sizeof(EmojicodeChar));
-            EmojicodeChar *chars = characters->value;
-            EmojicodeChar *writeChars = chars;
-            
-            Something sm = stackGetVariable(stringCount, thread);
-            String *string = sm.object->value;
-            
-            for (int i = 0; i < stringCount; i++) {
-                Object *o = stackGetVariable(i, thread).object;
-                String *string = o->value;
-                memcpy(writeChars, string->characters->value, string->length * sizeof(EmojicodeChar));
-                writeChars += string->length;
+        passBlock(thread);
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x62): { //MARK: If
+        Instruction *ifEnd = consumeInstruction(thread).target;
+        
+        Something boolSth = parse(thread);
+        bool b = unwrapBool(boolSth);
+        
+        if(b){
+            //The if itself was true
+            if(runBlock(thread)){
+                //We hit a return
+                return NOTHINGNESS;
             }
-            
-            string->length = length;
-            string->characters = characters;
-            
-            stackPop(thread);
-            
-            return sm;
+            thread->instructionPointer = ifEnd;
         }
-        //MARK: Flow Control
-        case 0x60: { //Red apple - return
-            thread->returnValue = parse(consumeCoin(thread), thread);
-            thread->returned = true;
+        else if(thread->instructionPointer >= ifEnd){
             return NOTHINGNESS;
         }
-        case 0x61: { //MARK: cherries
-            EmojicodeCoin *beginPosition = thread->tokenStream;
-            while (unwrapBool(parse(consumeCoin(thread), thread))) {
-                if(runBlock(thread)) {
-                    return NOTHINGNESS;
-                }
-                thread->tokenStream = beginPosition;
-            }
+        else {
+            //Get away the 1st orange block
             passBlock(thread);
-            return NOTHINGNESS;
-        }
-        case 0x62: { //MARK: If
-            EmojicodeCoin length = consumeCoin(thread);
-            EmojicodeCoin *ifEnd = thread->tokenStream + length;
             
-            Something boolSth = parse(consumeCoin(thread), thread);
-            bool b = unwrapBool(boolSth);
-            
-            if(b){
-                //The if itself was true
-                if(runBlock(thread)){
-                    //We hit a return
-                    return NOTHINGNESS;
-                }
-                thread->tokenStream = ifEnd;
-            }
-            else if(thread->tokenStream >= ifEnd){
-                return NOTHINGNESS;
-            }
-            else {
-                //Get away the 1st orange block
-                passBlock(thread);
+            while (thread->instructionPointer < ifEnd && nextCoin(thread) == 0x1F34B) { //All else ifs
+                consumeCoin(thread);
                 
-                while (thread->tokenStream < ifEnd && nextCoin(thread) == 0x1F34B) { //All else ifs
-                    consumeCoin(thread);
-                    
-                    boolSth = parse(consumeCoin(thread), thread);
-                    b = unwrapBool(boolSth);
-                    
-                    if (b) {
-                        //Its condition is true, so let's execute
-                        if(runBlock(thread)){
-                            return NOTHINGNESS;
-                        }
-                        thread->tokenStream = ifEnd;
-                        return NOTHINGNESS;
-                    }
-                    else {
-                        passBlock(thread);
-                    }
-                }
+                boolSth = parse(thread);
+                b = unwrapBool(boolSth);
                 
-                if(thread->tokenStream < ifEnd && nextCoin(thread) == 0x1F353){ //Else?
-                    consumeCoin(thread);
-                    
+                if (b) {
+                    //Its condition is true, so let's execute
                     if(runBlock(thread)){
                         return NOTHINGNESS;
                     }
+                    thread->instructionPointer = ifEnd;
+                    return NOTHINGNESS;
+                }
+                else {
+                    passBlock(thread);
                 }
             }
-            return NOTHINGNESS;
-        }
-        case 0x64: { //MARK: foreach
-            //The destination variable
-            EmojicodeCoin variable = consumeCoin(thread);
-            EmojicodeCoin enumeratorVindex = consumeCoin(thread);
-            
-            Object *iteratee = parse(consumeCoin(thread), thread).object;
-            
-            Something enumerator = performMethod(iteratee->class->protocolsTable[0][0], iteratee, thread);
-            stackSetVariable(enumeratorVindex, enumerator, thread);
-            
-            Method *nextMethod = enumerator.object->class->methodsVtable[0];
-            Method *moreComing = enumerator.object->class->methodsVtable[1];
-            
-            EmojicodeCoin *begin = thread->tokenStream;
             
-            while (unwrapBool(performMethod(moreComing, stackGetVariable(enumeratorVindex, thread).object, thread))) {
-                stackSetVariable(variable, performMethod(nextMethod, stackGetVariable(enumeratorVindex, thread).object, thread), thread);
+            if(thread->instructionPointer < ifEnd && nextCoin(thread) == 0x1F353){ //Else?
+                consumeCoin(thread);
                 
                 if(runBlock(thread)){
                     return NOTHINGNESS;
                 }
-                thread->tokenStream = begin;
             }
-            passBlock(thread);
-            
-            return NOTHINGNESS;
         }
-        case 0x65: { //MARK: foreach for lists
-            //The destination variable
-            EmojicodeCoin variable = consumeCoin(thread);
-            EmojicodeCoin listObjectVariable = consumeCoin(thread);
-            
-            //Get the list
-            Something losm = parse(consumeCoin(thread), thread);
-            
-            stackSetVariable(listObjectVariable, losm, thread);
-            List *list = losm.object->value;
-            
-            EmojicodeCoin *begin = thread->tokenStream;
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x64): { //MARK: foreach
+        //The destination variable
+        EmojicodeCoin variable = consumeCoin(thread);
+        EmojicodeCoin enumeratorVindex = consumeCoin(thread);
+        
+        Object *iteratee = parse(thread).object;
+        
+        Something enumerator = performMethod(iteratee->class->protocolsTable[0][0], iteratee, thread);
+        stackSetVariable(enumeratorVindex, enumerator, thread);
+        
+        Method *nextMethod = enumerator.object->class->methodsVtable[0];
+        Method *moreComing = enumerator.object->class->methodsVtable[1];
+        
+        Instruction *begin = thread->instructionPointer;
+        
+        while (unwrapBool(performMethod(moreComing, stackGetVariable(enumeratorVindex, thread).object, thread))) {
+            stackSetVariable(variable, performMethod(nextMethod, stackGetVariable(enumeratorVindex, thread).object, thread), thread);
             
-            for (size_t i = 0, l = list->count; i < l; i++) {
-                stackSetVariable(variable, listGet(stackGetVariable(listObjectVariable, thread).object->value, i), thread);
-                
-                if(runBlock(thread)){
-                    return NOTHINGNESS;
-                }
-                thread->tokenStream = begin;
+            if(runBlock(thread)){
+                return NOTHINGNESS;
             }
-            passBlock(thread);
-            
-            return NOTHINGNESS;
+            pollSafepoint(thread);
+            thread->instructionPointer = begin;
         }
-        case 0x67: { //MARK: guard
-            Something value = parse(consumeCoin(thread), thread);
+        passBlock(thread);
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x65): { //MARK: foreach for lists
+        //The destination variable
+        EmojicodeCoin variable = consumeCoin(thread);
+        EmojicodeCoin listObjectVariable = consumeCoin(thread);
+        
+        //Get the list
+        Something losm = parse(thread);
+        
+        stackSetVariable(listObjectVariable, losm, thread);
+        List *list = objectValue(losm.object);
+        
+        Instruction *begin = thread->instructionPointer;
+        
+        for (size_t i = 0, l = list->count; i < l; i++) {
+            stackSetVariable(variable, listGet(objectValue(stackGetVariable(listObjectVariable, thread).object), i), thread);
             
-            if (isNothingness(value)) {
-                if (runBlock(thread)) {
-                    return NOTHINGNESS;
-                }
+            if(runBlock(thread)){
+                return NOTHINGNESS;
             }
-            else {
-                passBlock(thread);
+            pollSafepoint(thread);
+            thread->instructionPointer = begin;
+        }
+        passBlock(thread);
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x67): { //MARK: guard
+        Something value = parse(thread);
+        
+        if (isNothingness(value)) {
+            if (runBlock(thread)) {
+                return NOTHINGNESS;
             }
-            
-            return NOTHINGNESS;
         }
-        case 0x70: {
-            stackPush(stackGetThis(thread), 1, 0, thread);
-            stackSetVariable(0, somethingObject(newObject(CL_CLOSURE)), thread);
-            
-            uint8_t variableCount = consumeCoin(thread);
-            Object *capturedVariables = newArray(sizeof(Something) * variableCount);
-            
-            Object *co = stackGetVariable(0, thread).object;
-            Closure *c = co->value;
-            c->capturedVariables = capturedVariables;
-            
-            c->coinCount = consumeCoin(thread);
-            c->tokenStream = thread->tokenStream;
-            thread->tokenStream += c->coinCount;
-            
-            EmojicodeCoin argumentCount = consumeCoin(thread);
-            c->argumentCount = argumentCount;
-            
-            stackPop(thread);
-            
-            Something *t = capturedVariables->value;
-            c->capturedVariablesCount = consumeCoin(thread);
-            for (uint_fast8_t i = 0; i < c->capturedVariablesCount; i++) {
-                t[i] = stackGetVariable(i, thread);
+        else {
+            passBlock(thread);
+        }
+        
+        return NOTHINGNESS;
+    }
+    INSTRUCTION(0x70): {
+        stackPush(stackGetThis(thread), 1, 0, thread);
+        stackSetVariable(0, somethingObject(newObject(CL_CLOSURE)), thread);
+        
+        uint8_t variableCount = consumeCoin(thread);
+        Object *capturedVariables = newArray(sizeof(Something) * variableCount);
+        
+        Object *co = stackGetVariable(0, thread).object;
+        Closure *c = objectValue(co);
+        c->variableCount = variableCount;
+        c->capturedVariables = capturedVariables;
+        writeBarrier(co, somethingObject(capturedVariables));
+        
+        Instruction *closureEnd = consumeInstruction(thread).target;
+        c->instructions = thread->instructionPointer;
+        c->instructionCount = (uint32_t)(closureEnd - thread->instructionPointer);
+        thread->instructionPointer = closureEnd;
+        
+        EmojicodeCoin argumentCount = consumeCoin(thread);
+        c->argumentCount = argumentCount;
+        
+        stackPop(thread);
+        
+        Something *t = objectValue(capturedVariables);
+        c->capturedVariablesCount = consumeCoin(thread);
+        c->allocationFree = consumeCoin(thread);
+        for (uint_fast8_t i = 0; i < c->capturedVariablesCount; i++) {
+            t[i] = stackGetVariable(i, thread);
+        }
+        
+        if (argumentCount >> 16) {
+            c->this = stackGetThis(thread);
+            writeBarrier(co, somethingObject(c->this));
+        }
+        
+        return somethingObject(co);
+    }
+    INSTRUCTION(0x71): {
+        stackPush(parse(thread).object, 0, 0, thread);
+        Object *cmco = newObject(CL_CAPTURED_METHOD_CALL);
+        CapturedMethodCall *cmc = objectValue(cmco);
+        
+        EmojicodeCoin vti = consumeCoin(thread);
+        InlineCache *cache = consumeInstruction(thread).cache;
+        Class *class = stackGetThis(thread)->class;
+        
+        cmc->method = inlineCacheLookup(cache, class);
+        if (!cmc->method) {
+            cmc->method = class->methodsVtable[vti];
+            inlineCacheStore(cache, class, cmc->method);
+        }
+        cmc->object = stackGetThis(thread);
+        stackPop(thread);
+        return somethingObject(cmco);
+    }
+    INSTRUCTION(0x72): {
+        Object *callable = parse(thread).object;
+        if (callable->class == CL_CAPTURED_METHOD_CALL) {
+            CapturedMethodCall *cmc = objectValue(callable);
+            return performMethod(cmc->method, cmc->object, thread);
+        }
+        else {
+            {
+                Closure *c = objectValue(callable);
+                
+                stackPush(callable, c->variableCount, c->argumentCount, thread);
+            }
+            Closure *c = objectValue(stackGetThis(thread));
+            Something *cv = objectValue(c->capturedVariables);
+            for (uint8_t i = 0; i < c->capturedVariablesCount; i++) {
+                stackSetVariable(c->argumentCount + i, cv[i], thread);
             }
+            ((StackFrame*)thread->stack)->this = c->this;
             
-            if (argumentCount >> 16)
-                c->this = stackGetThis(thread);
+            //The closure might be moved at the safepoint
+            Instruction *instructions = c->instructions;
+            uint32_t instructionCount = c->instructionCount;
+            pollSafepoint(thread);
             
-            return somethingObject(co);
-        }
-        case 0x71: {
-            stackPush(parse(consumeCoin(thread), thread).object, 0, 0, thread);
-            Object *cmco = newObject(CL_CAPTURED_METHOD_CALL);
-            CapturedMethodCall *cmc = cmco->value;
+            Instruction *preInstructionPointer = thread->instructionPointer;
+            thread->instructionPointer = instructions;
+            Something ret = runFunctionBlock(thread, instructionCount);
+            thread->instructionPointer = preInstructionPointer;
             
-            EmojicodeCoin vti = consumeCoin(thread);
-            cmc->method = stackGetThis(thread)->class->methodsVtable[vti];
-            cmc->object = stackGetThis(thread);
             stackPop(thread);
-            return somethingObject(cmco);
-        }
-        case 0x72: {
-            Object *callable = parse(consumeCoin(thread), thread).object;
-            if (callable->class == CL_CAPTURED_METHOD_CALL) {
-                CapturedMethodCall *cmc = callable->value;
-                return performMethod(cmc->method, cmc->object, thread);
-            }
-            else {
-                {
-                    Closure *c = callable->value;
-                    
-                    stackPush(callable, c->variableCount, c->argumentCount, thread);
-                }
-                Closure *c = stackGetThis(thread)->value;
-                Something *cv = c->capturedVariables->value;
-                for (uint8_t i = 0; i < c->capturedVariablesCount; i++) {
-                    stackSetVariable(c->argumentCount + i, cv[i], thread);
-                }
-                ((StackFrame*)thread->stack)->this = c->this;
-                
-                EmojicodeCoin *preCoinStream = thread->tokenStream;
-                thread->tokenStream = c->tokenStream;
-                Something ret = runFunctionBlock(thread, c->coinCount);
-                thread->tokenStream = preCoinStream;
-                
-                stackPop(thread);
-                return ret;
-            }
+            return ret;
         }
     }
-    return NOTHINGNESS;
 }
 
+#undef INSTRUCTION
+
 int main(int argc, char *argv[]) {
     setlocale(LC_CTYPE, "de_DE.UTF-8");
     if (argc != 2){
@@ -825,12 +1064,20 @@ int main(int argc, char *argv[]) {
        error("File couldn't be opened.");
     }
     
-    mainThread = allocateThread();
+    if (getenv("EMOJICODE_INLINE_CACHE_STATS")) {
+        inlineCacheStatisticsEnabled = true;
+        atexit(reportInlineCacheStatistics);
+    }
+    jitConfigure();
+    dictionaryInitializeHashSeed();
+    
+    mainThread = currentThread = allocateThread();
+    leaveBlockingRegion(mainThread);
     
     allocateHeap();
     
     Class *cl;
     ClassMethod *flagMethod = readBytecode(f, &cl);
 
-    return (int)performClassMethod(flagMethod, cl, mainThread).raw;
+    return (int)unwrapInteger(performClassMethod(flagMethod, cl, mainThread));
 }
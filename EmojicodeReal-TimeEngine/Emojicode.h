@@ -12,6 +12,89 @@
 #define _GNU_SOURCE
 #include "EmojicodeAPI.h"
 
+//MARK: Instructions
+
+/** The number of receiver classes an inline cache remembers before the call site is considered megamorphic. */
+#define inlineCacheSize 4
+
+/**
+ * The inline cache of a single method call site. It maps the classes of the receivers seen at the call site to the
+ * method that is called on them. A cache with one class is monomorphic, one with more classes polymorphic.
+ */
+typedef struct {
+    Class *classes[inlineCacheSize];
+    Method *methods[inlineCacheSize];
+    uint8_t count;
+    /** Set while a thread stores an entry. Entries are published by incrementing @c count afterwards. */
+    bool storing;
+} InlineCache;
+
+/** Whether the inline cache hits and misses are counted, which is the case if EMOJICODE_INLINE_CACHE_STATS is set. */
+extern bool inlineCacheStatisticsEnabled;
+/** The number of calls whose method was found in the call site’s inline cache. */
+extern uint64_t inlineCacheHits;
+/** The number of calls whose method had to be looked up in the method tables. */
+extern uint64_t inlineCacheMisses;
+
+/** Prints the inline cache hit and miss rates to @c stderr. */
+void reportInlineCacheStatistics(void);
+
+/**
+ * A cell of a pre-decoded instruction stream. The coins of every procedure are lowered into an array of these cells
+ * when the bytecode file is loaded (see @c lowerScheduledBlocks). A cell either holds the address of an instruction’s
+ * implementation within @c parse, which is used for direct-threaded dispatch, or an already decoded operand.
+ */
+typedef union Instruction {
+    /** The address of the instruction’s implementation in @c parse. */
+    const void *handler;
+    /** A plain operand like a variable index or a vtable index. */
+    EmojicodeCoin coin;
+    /** A pre-computed integer literal. */
+    EmojicodeInteger integer;
+    /** A pre-computed double literal. */
+    double doubl;
+    /** A resolved class. @c NULL if the class must be taken from the current stack frame. */
+    Class *class;
+    /** The entry in the string pool the instruction refers to. */
+    Object **string;
+    /** An absolute jump target, e.g. the end of a block. */
+    union Instruction *target;
+    /** The inline cache of a method call site. */
+    InlineCache *cache;
+    /** A counter incremented by the instruction, e.g. the hotness of the procedure a loop belongs to. */
+    uint32_t *counter;
+} Instruction;
+
+//MARK: JIT
+
+/** Native code produced by the JIT. It is passed the variables of the procedure’s stack frame. */
+typedef Something (*JITFunction)(Something *variables);
+
+/** The state of a procedure with regard to the JIT. */
+typedef struct {
+    /** The native code of the procedure or @c NULL if it was not compiled. */
+    JITFunction code;
+    /** The number of invocations and loop iterations. The procedure is compiled once this reaches the threshold. */
+    uint32_t hotness;
+    /** Whether compiling the procedure was attempted. */
+    bool attempted;
+} JITState;
+
+/** Whether the JIT is enabled. Set by @c jitConfigure. */
+extern bool jitEnabled;
+
+/**
+ * Configures the JIT from the environment. The JIT is enabled if @c EMOJICODE_JIT is set to a value other than 0.
+ * @c EMOJICODE_JIT_THRESHOLD sets the hotness at which procedures are compiled.
+ */
+void jitConfigure(void);
+
+/**
+ * Counts an invocation of the procedure and compiles it once it is hot.
+ * @returns Whether native code is available for the procedure.
+ */
+bool jitTierUp(JITState *jit, Instruction *instructions, uint32_t instructionCount);
+
 //MARK: Stack
 
 struct StackFrame {
@@ -24,20 +107,56 @@ struct StackFrame {
     void *returnFutureStack;
 };
 
-/** Try to allocate a thread and a stack. */
+/**
+ * Try to allocate a thread and a stack. The thread is registered with the collector and starts in a blocking region,
+ * see @c leaveBlockingRegion.
+ */
 Thread* allocateThread(void);
 
 /** Marks all variables on the stack */
 void stackMark(Thread *);
 
+/** Returns a pointer to the first variable of the current stack frame. */
+Something* stackVariables(Thread *);
+
 /**
- * The garbage collector.
- * Not thread-safe!
+ * The garbage collector. Performs a full collection of the nursery and the old generation after all other threads
+ * stopped at a safepoint. If another thread started a collection meanwhile, @c thread is stopped until that collection
+ * finished and no further collection is performed.
  */
 void gc(Thread *thread);
 
+/**
+ * Set when integer boxes, which are allocated without invoking the GC, exhausted the old generation. The interpreter
+ * then performs a full collection at the next safepoint.
+ */
+extern bool collectionRequested;
+
+//MARK: Workers
+
+/**
+ * Processes the indices [from, to) of a parallel job on @c thread. @c chunk is the index of this range, the ranges
+ * are numbered in ascending order of their indices.
+ */
+typedef void (*ParallelBody)(void *context, size_t from, size_t to, size_t chunk, Thread *thread);
+
+/** Returns the number of indices of the chunks a parallel job of @c count indices is split into. */
+size_t parallelChunkSize(size_t count);
+
+/** Returns whether a job of @c count indices would be run by more than one thread. */
+bool parallelWorthwhile(size_t count);
+
+/**
+ * Calls @c body for chunks of @c chunkSize indices until all @c count indices were processed. The chunks are
+ * distributed across the worker threads and the calling thread, which is @c thread. The worker pool is started on
+ * first use. Its size is read from @c EMOJICODE_WORKERS and defaults to the number of processors.
+ *
+ * @c body must not invoke the Garbage Collector and must not call code that might.
+ */
+void parallelFor(size_t count, size_t chunkSize, ParallelBody body, void *context, Thread *thread);
+
 struct Thread {
-    EmojicodeCoin *tokenStream;
+    Instruction *instructionPointer;
     Something returnValue;
     bool returned;
     
@@ -45,10 +164,83 @@ struct Thread {
     Byte *stackBottom;
     Byte *stack;
     Byte *futureStack;
+    
+    /** The thread-local allocation buffer, a part of the nursery in which this thread allocates without locking. */
+    Byte *allocationPointer;
+    Byte *allocationLimit;
+    
+    /**
+     * Whether the thread ignores safepoints. This is the case for the workers, which only run allocation-free
+     * closures, and for a thread while it runs a parallel job.
+     */
+    bool safepointsDisabled;
+    /** Set once the thread finished, see @c threadFinish. */
+    bool finished;
+    
+    Thread *previousThread;
+    Thread *nextThread;
 };
 
 Thread *mainThread;
 
+//MARK: Threads
+
+/**
+ * The thread the current operating system thread runs. The allocator uses its thread-local allocation buffer and
+ * stack.
+ */
+extern _Thread_local Thread *currentThread;
+
+/**
+ * Set when the threads must call @c safepoint, either because a thread is waiting for all others to stop for a
+ * collection or because @c collectionRequested was set.
+ */
+extern volatile bool safepointRequested;
+
+/** Registers @c thread, which must be in a blocking region, with the collector. Called by @c allocateThread. */
+void threadRegister(Thread *thread);
+
+/** Calls @c safepoint if the thread must stop. This is done at loop backedges and calls. */
+#define pollSafepoint(thread) if (safepointRequested) safepoint(thread)
+
+/**
+ * Stops the thread until the collection another thread is about to perform finished, or performs the collection
+ * requested by @c collectionRequested. The Garbage Collector might run, so all objects must be reachable from the
+ * stack.
+ */
+void safepoint(Thread *thread);
+
+/** Blocks @c thread until @c other finished. */
+void threadJoin(Thread *thread, Thread *other);
+
+/**
+ * Removes the thread, which must not access the heap anymore, from the threads known to the collector and releases
+ * its stack. The thread structure itself is kept so that @c threadJoin can still be called for it.
+ */
+void threadFinish(Thread *thread);
+
+/**
+ * Waits until all other threads stopped at a safepoint or entered a blocking region. If another thread is already
+ * about to collect, @c thread is stopped until it finished and false is returned.
+ */
+bool stopTheWorld(Thread *thread);
+
+/** Lets the threads stopped by @c stopTheWorld continue. */
+void resumeTheWorld(void);
+
+/** Marks the stacks of all threads. Must only be called while the world is stopped. */
+void threadsMarkStacks(void);
+
+/** Discards the allocation buffers of all threads after the nursery was collected. */
+void threadsResetAllocationBuffers(void);
+
+/** The value of an instance of 🧵, which runs a callable on its own operating system thread. */
+typedef struct {
+    Thread *thread;
+    /** The value the callable returned, which is only set once the thread finished. */
+    Something result;
+} EmojicodeThread;
+
 
 //MARK: VM
 
@@ -56,10 +248,20 @@ Byte *currentHeap;
 Byte *otherHeap;
 void allocateHeap(void);
 
+/** The default maximum heap size, which can be changed with the EMOJICODE_HEAP_SIZE environment variable. */
 #ifndef heapSize
 #define heapSize (512 * 1000 * 1000) //512 MB
 #endif
 
+/** The default heap size at startup, which can be changed with the EMOJICODE_HEAP_INITIAL_SIZE environment variable. */
+#ifndef initialHeapSize
+#define initialHeapSize (32 * 1000 * 1000) //32 MB
+#endif
+
+#ifndef nurserySize
+#define nurserySize (8 * 1000 * 1000) //8 MB
+#endif
+
 /** The class table */
 Class **classTable;
 
@@ -69,6 +271,40 @@ Object **stringPool;
 /** Whether the given pointer points into the heap. */
 extern bool isPossibleObjectPointer(void *);
 
+/**
+ * Returns a hash of the identity of @c object. Unlike the address of the object, the hash does not change when the
+ * garbage collector moves the object.
+ */
+extern uint64_t objectIdentityHash(Object *object);
+
+/** The number of buckets in the pause histogram. Bucket @c i counts pauses shorter than 10^(i + 2) microseconds. */
+#define gcPauseHistogramSize 5
+
+/** Statistics about the work done by the garbage collector since the program started. */
+typedef struct {
+    uint64_t nurseryCollections;
+    uint64_t fullCollections;
+    uint64_t pauseNanoseconds;
+    uint64_t maximumPauseNanoseconds;
+    uint64_t pauseHistogram[gcPauseHistogramSize];
+    /** The size of all objects whose references were traced. */
+    uint64_t bytesScanned;
+    /** The size of all objects that were evacuated. */
+    uint64_t bytesCopied;
+    /** The size of the nursery contents that nursery collections evacuated from, and the size that survived. */
+    uint64_t nurseryBytesCollected;
+    uint64_t nurseryBytesSurvived;
+    uint64_t objectsFinalized;
+} GCStatistics;
+
+extern GCStatistics gcStatistics;
+
+/** Returns the number of bytes that are currently occupied by objects. */
+extern size_t heapOccupancy(void);
+
+/** Prints a summary of @c gcStatistics to @c stderr. */
+void reportGCStatistics(void);
+
 //MARK: Classes
 
 struct Class {
@@ -95,9 +331,15 @@ struct Class {
     /** Marker Function for GC */
     void (*mark)(Object *self);
     
+    /** The size of an instance without the object header: the value area followed by the instance variables. */
     size_t size;
+    /** The size of the value area, which is a multiple of 8. */
+    size_t valueSize;
 };
 
+/** Returns a pointer to the instance variables of @c object, which follow its value area. */
+#define objectVariables(object) ((Something *)((Byte *)objectValue(object) + (object)->class->valueSize))
+
 struct Method {
     /** Number of arguments. */
     uint8_t argumentCount;
@@ -110,10 +352,11 @@ struct Method {
         /** Function pointer to execute the method. */
         MethodHandler handler;
         struct {
-            /** The method’s token stream */
-            EmojicodeCoin *tokenStream;
-            /** The number of tokens */
-            uint32_t tokenCount;
+            /** The method’s pre-decoded instructions */
+            Instruction *instructions;
+            /** The number of instruction cells */
+            uint32_t instructionCount;
+            JITState jit;
         };
     };
 };
@@ -130,10 +373,11 @@ struct ClassMethod {
         /** Function pointer to execute the class method. */
         ClassMethodHandler handler;
         struct {
-            /** The method’s token stream */
-            EmojicodeCoin *tokenStream;
-            /** The number of tokens */
-            uint32_t tokenCount;
+            /** The method’s pre-decoded instructions */
+            Instruction *instructions;
+            /** The number of instruction cells */
+            uint32_t instructionCount;
+            JITState jit;
         };
     };
 };
@@ -150,10 +394,10 @@ struct Initializer {
         /** Function pointer to execute the method. */
         InitializerHandler handler;
         struct {
-            /** The initializer’s token stream */
-            EmojicodeCoin *tokenStream;
-            /** The number of tokens */
-            uint32_t tokenCount;
+            /** The initializer’s pre-decoded instructions */
+            Instruction *instructions;
+            /** The number of instruction cells */
+            uint32_t instructionCount;
         };
     };
 };
@@ -164,21 +408,30 @@ typedef struct {
 } CapturedMethodCall;
 
 typedef struct {
-    EmojicodeCoin *tokenStream;
-    uint32_t coinCount;
+    Instruction *instructions;
+    uint32_t instructionCount;
     uint8_t argumentCount;
     uint8_t capturedVariablesCount;
     uint8_t variableCount;
     Object *capturedVariables;
     void *this;
+    /**
+     * Whether the closure neither allocates objects, nor calls methods or callables, nor modifies objects. Such
+     * closures can be run on worker threads.
+     */
+    bool allocationFree;
 } Closure;
 
 //MARK: Parsing
 
-EmojicodeCoin consumeCoin(Thread *thread);
+/** Executes the instruction at the thread’s instruction pointer and returns its value. */
+Something parse(Thread *);
 
-/** Parse a token */
-Something parse(EmojicodeCoin coin, Thread *);
+/**
+ * Returns the address of the implementation of the instruction @c opcode for use in an instruction cell.
+ * Unknown opcodes are mapped to an implementation which does nothing.
+ */
+const void* instructionHandler(EmojicodeCoin opcode);
 
 /** Throw a runtime error */
 _Noreturn void error(char *err, ...);
@@ -200,6 +453,19 @@ void objectIncrementVariable(Object *o, uint8_t index);
 ClassMethod* readBytecode(FILE *in, Class **cl);
 
 
+//MARK: Lowering
+
+/**
+ * Schedules the given coins for lowering. Once lowered, @c *instructions is set to the pre-decoded instructions
+ * and @c *instructionCount to their number. The coins are freed.
+ * @param hotness The counter loops in the coins increment on every iteration. May be @c NULL.
+ */
+void scheduleLowering(EmojicodeCoin *coins, uint32_t coinCount, Instruction **instructions, uint32_t *instructionCount, uint32_t *hotness);
+
+/** Lowers all scheduled coin streams. Must be called after all classes and the string pool were read. */
+void lowerScheduledBlocks(void);
+
+
 //MARK: Packages
 
 /** Determines whether the loading of a package was succesfull */
@@ -6,344 +6,499 @@
 //  Copyright (c) 2015 Theo Weidmann. All rights reserved.
 //
 
-#include "EmojicodeAPI.h"
+#include "Emojicode.h"
 #include "EmojicodeDictionary.h"
 #include "EmojicodeString.h"
+#include <string.h>
 
-#define FNV_PRIME_64 1099511628211
-#define FNV_OFFSET_64 14695981039346656037U
-EmojicodeDictionaryHash fnv64(const char *k, size_t length) {
-    EmojicodeDictionaryHash hash = FNV_OFFSET_64;
-    for(size_t i = 0; i < length; i++){
-        hash = hash ^ k[i];
-        hash = hash * FNV_PRIME_64;
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//MARK: Hashing
+
+static uint64_t hashSeed;
+
+void dictionaryInitializeHashSeed(void){
+#if defined __FreeBSD__ || defined __APPLE__ || defined __OpenBSD__ || defined __NetBSD__
+    arc4random_buf(&hashSeed, sizeof(hashSeed));
+#else
+    FILE *fp = fopen("/dev/urandom", "r");
+    if (!fp || fread(&hashSeed, 1, sizeof(hashSeed), fp) != sizeof(hashSeed)) {
+        error("Could not read a random seed from /dev/urandom.");
     }
-    return hash;
+    fclose(fp);
+#endif
 }
 
-EmojicodeDictionaryHash dictionaryHash(EmojicodeDictionary *dict, Object *key) {
-    #define hashString(keyString) fnv64((char*)characters(keyString), ((keyString)->length) * sizeof(EmojicodeChar))
-    return hashString((String *) key->value);
+#define HASH_SECRET_0 0xa0761d6478bd642fULL
+#define HASH_SECRET_1 0xe7037ed1a0b428dbULL
+
+/** Multiplies @c a and @c b and folds the 128-bit product into 64 bits. */
+static inline uint64_t hashMix(uint64_t a, uint64_t b){
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ah = a >> 32, al = (uint32_t)a, bh = b >> 32, bl = (uint32_t)b;
+    uint64_t hl = ah * bl, lh = al * bh, ll = al * bl;
+    uint64_t middle = (ll >> 32) + (uint32_t)hl + (uint32_t)lh;
+    uint64_t low = (middle << 32) | (uint32_t)ll;
+    uint64_t high = ah * bh + (hl >> 32) + (lh >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
 }
 
-bool dictionaryKeyEqual(EmojicodeDictionary *dict, Object *key1, Object *key2) {
-    return stringEqual((String *) key1->value, (String *) key2->value);
+static inline uint64_t read64(const uint8_t *p){
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
 }
 
-bool dictionaryKeyHashEqual(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash1, EmojicodeDictionaryHash hash2, Object *key1, Object *key2) {
-    return (hash1 == hash2) && dictionaryKeyEqual(dict, key1, key2);
+static inline uint64_t read32(const uint8_t *p){
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
 }
 
-// MARK: Internal dictionary
-EmojicodeDictionaryNode* dictionaryGetNode(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Object *key) {
-    EmojicodeDictionaryNode *e;
-    Object** bucko;
-    size_t n = 0;
-    if (dict->buckets != NULL) {
-        bucko = (Object**) dict->buckets->value;
-        if ((n = dict->bucketsCounter) > 0) {
-            Object *firsto = bucko[hash & (n - 1)];
-            if (firsto != NULL) {
-                e = firsto->value;
-                if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                    return e;
-                }
-                Object *eo;
-                while ((eo = e->next)) {
-                    e = eo->value;
-                    if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                        return e;
-                    }
-                }
-            }
+/* A wyhash-style hash that consumes 16 bytes per round with one 64×64 multiplication. */
+EmojicodeDictionaryHash dictionaryHashBytes(const void *bytes, size_t length){
+    const uint8_t *p = bytes;
+    uint64_t seed = hashSeed ^ HASH_SECRET_0;
+    uint64_t a, b;
+    
+    if (length <= 16) {
+        if (length >= 8) {
+            a = read64(p);
+            b = read64(p + length - 8);
+        }
+        else if (length >= 4) {
+            a = read32(p);
+            b = read32(p + length - 4);
+        }
+        else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
         }
     }
-    return NULL;
+    else {
+        size_t left = length;
+        while (left > 16) {
+            seed = hashMix(read64(p) ^ HASH_SECRET_1, read64(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        a = read64(p + left - 16);
+        b = read64(p + left - 8);
+    }
+    
+    return hashMix(HASH_SECRET_1 ^ length, hashMix(a ^ HASH_SECRET_1, b ^ seed));
 }
 
-/** @warning GC-Invoking */
-Object* dictionaryNewNode(Object **dicto, EmojicodeDictionaryHash hash, Object *key, Something value, Object *next, Thread *thread){
-    stackPush(*dicto, 0, 0, thread);
-    Object *nodeo = newArray(sizeof(EmojicodeDictionaryNode));
-    EmojicodeDictionaryNode *node = (EmojicodeDictionaryNode *) nodeo->value;
-    *dicto = stackGetThis(thread);
-    stackPop(thread);
-    
-    node->hash = hash;
-    node->key = key;
-    node->value = value;
-    node->next = next;
-    return nodeo;
+/** Hashes a single 64-bit value, e.g. an integer or the address of an object. */
+static inline EmojicodeDictionaryHash hashWord(uint64_t word){
+    return hashMix(HASH_SECRET_1 ^ sizeof(word), hashMix(word ^ HASH_SECRET_1, hashSeed ^ HASH_SECRET_0));
 }
 
-/** @warning GC-Invoking */
-Object* dictionaryResize(Object *dicto, Thread *thread) {
-    EmojicodeDictionary *dict = dicto->value;
+static inline EmojicodeDictionaryHash dictionaryHash(Something key) {
+    if (isRealObject(key)) {
+        if (key.object->class == CL_STRING) {
+            return stringHash((String *) objectValue(key.object));
+        }
+        if (isIntegerBox(key.object)) {
+            return hashWord((uint64_t)unboxInteger(key.object));
+        }
+        return hashWord(objectIdentityHash(key.object));
+    }
+    //Inline integers are hashed by their value, just like boxed ones
+    if (isInlineInteger(key)) {
+        return hashWord((uint64_t)unwrapInteger(key));
+    }
+    return hashWord(key.bits);
+}
 
-    Object *oldBuckoo = dict->buckets;
-    size_t oldCap = (oldBuckoo == NULL) ? 0 : dict->bucketsCounter;
-    size_t oldThr = dict->nextThreshold;
-    size_t newCap = oldCap << 1, newThr = 0;
-    
-    if (oldCap > 0) {
-        if (oldCap >= DICTIONARY_MAXIMUM_CAPACTIY) {
-            dict->nextThreshold = DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD;
-            return dicto;
+static inline bool dictionaryKeyEqual(Something key1, Something key2) {
+    if (key1.bits == key2.bits) {
+        return true;
+    }
+    if (!isRealObject(key1) || !isRealObject(key2) || key1.object->class != key2.object->class) {
+        return false;
+    }
+    if (key1.object->class == CL_STRING) {
+        return stringEqual((String *) objectValue(key1.object), (String *) objectValue(key2.object));
+    }
+    return isIntegerBox(key1.object) && unboxInteger(key1.object) == unboxInteger(key2.object);
+}
+
+// MARK: Groups
+
+/** A bit mask with a bit set for every control byte of a group that matched. */
+typedef uint32_t DictionaryGroupMask;
+
+/** Returns a mask of the control bytes in the group at @c group that are equal to @c h2. */
+static inline DictionaryGroupMask groupMatch(const uint8_t *group, uint8_t h2){
+#if defined(__SSE2__)
+    __m128i control = _mm_loadu_si128((const __m128i *)group);
+    return (DictionaryGroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)h2)));
+#else
+    DictionaryGroupMask mask = 0;
+    for (uint_fast8_t i = 0; i < DICTIONARY_GROUP_WIDTH; i++) {
+        if (group[i] == h2) {
+            mask |= 1u << i;
         }
-        else if (newCap < DICTIONARY_MAXIMUM_CAPACTIY && oldCap >= DICTIONARY_DEFAULT_INITIAL_CAPACITY) {
-            newThr = oldThr << 1; // double threshold
+    }
+    return mask;
+#endif
+}
+
+/** Returns a mask of the control bytes in the group that belong to slots without an item. */
+static inline DictionaryGroupMask groupMatchEmptyOrDeleted(const uint8_t *group){
+#if defined(__SSE2__)
+    //Only the control bytes of empty and deleted slots have the highest bit set
+    return (DictionaryGroupMask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    DictionaryGroupMask mask = 0;
+    for (uint_fast8_t i = 0; i < DICTIONARY_GROUP_WIDTH; i++) {
+        if (group[i] & 0x80) {
+            mask |= 1u << i;
         }
     }
-    else if (oldThr > 0) { // initial capacity was placed in threshold
-        newCap = oldThr;
+    return mask;
+#endif
+}
+
+#define groupFirst(mask) ((size_t)__builtin_ctz(mask))
+#define groupLast(mask) ((size_t)(31 - __builtin_clz(mask)))
+
+#define h1(hash) ((hash) >> 7)
+#define h2(hash) ((uint8_t)((hash) & 0x7F))
+
+/** Sets the control byte of slot @c i and its mirror. */
+static inline void dictionarySetControl(EmojicodeDictionary *dict, size_t i, uint8_t value){
+    uint8_t *control = dictionaryControl(dict);
+    control[i] = value;
+    if (i < DICTIONARY_GROUP_WIDTH) {
+        control[dict->capacity + i] = value;
+    }
+}
+
+/*
+ * The groups are probed quadratically, i.e. the probe moves by one, two, three, ... group widths, which visits
+ * every group of a power of two sized table.
+ */
+#define forEachProbe(dict, hash, offset) \
+    for (size_t offset = h1(hash) & ((dict)->capacity - 1), step_ = DICTIONARY_GROUP_WIDTH; ; \
+         offset = (offset + step_) & ((dict)->capacity - 1), step_ += DICTIONARY_GROUP_WIDTH)
+
+// MARK: Internal dictionary
+
+static EmojicodeDictionarySlot* dictionaryFindSlot(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash,
+                                                   Something key){
+    if (dict->slots == NULL) {
+        return NULL;
+    }
+    uint8_t *control = dictionaryControl(dict);
+    EmojicodeDictionarySlot *slots = dictionarySlots(dict);
+    size_t mask = dict->capacity - 1;
+    
+    forEachProbe(dict, hash, offset) {
+        for (DictionaryGroupMask matches = groupMatch(control + offset, h2(hash)); matches; matches &= matches - 1) {
+            EmojicodeDictionarySlot *slot = slots + ((offset + groupFirst(matches)) & mask);
+            if (slot->hash == hash && dictionaryKeyEqual(key, slot->key)) {
+                return slot;
+            }
+        }
+        //The key would have been inserted into the first empty slot
+        if (groupMatch(control + offset, DICTIONARY_EMPTY)) {
+            return NULL;
+        }
     }
-    else { // zero initial threshold signifies using defaults
-        newCap = DICTIONARY_DEFAULT_INITIAL_CAPACITY;
-        newThr = (size_t) (DICTIONARY_DEFAULT_LOAD_FACTOR * DICTIONARY_DEFAULT_INITIAL_CAPACITY);
+}
+
+/** Returns the index of the first slot without an item on the probe sequence of @c hash. */
+static size_t dictionaryFindInsertPosition(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash){
+    uint8_t *control = dictionaryControl(dict);
+    forEachProbe(dict, hash, offset) {
+        DictionaryGroupMask free = groupMatchEmptyOrDeleted(control + offset);
+        if (free) {
+            return (offset + groupFirst(free)) & (dict->capacity - 1);
+        }
     }
+}
+
+/**
+ * Moves all items into a new slot array. The capacity is only doubled if more than half of the maximum load are
+ * items, otherwise rehashing just gets rid of the deleted slots.
+ * @warning GC-Invoking
+ */
+static Object* dictionaryResize(Object *dicto, Thread *thread) {
+    EmojicodeDictionary *dict = objectValue(dicto);
     
-    if (newThr == 0) {
-        float ft = (float) newCap * dict->loadFactor;
-        newThr = (newCap < DICTIONARY_MAXIMUM_CAPACTIY && ft < (float)DICTIONARY_MAXIMUM_CAPACTIY) ? (size_t)ft : DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD;
+    size_t capacity = dict->capacity ? dict->capacity : DICTIONARY_MINIMUM_CAPACITY;
+    if (dict->capacity && dict->size >= dictionaryMaximumLoad(capacity) / 2) {
+        capacity <<= 1;
+    }
+    if (capacity > DICTIONARY_MAXIMUM_CAPACTIY) {
+        error("The dictionary became too large.");
     }
     
     stackPush(dicto, 0, 0, thread);
-    Object *newBuckoo = newArray(newCap * sizeof(Object *));
+    Object *newSlotso = newArray(dictionaryControlSize(capacity) + capacity * sizeof(EmojicodeDictionarySlot));
     dicto = stackGetThis(thread);
-    dict = dicto->value;
+    dict = objectValue(dicto);
     stackPop(thread);
     
-    dict->buckets = newBuckoo;
-    dict->nextThreshold = newThr;
-    dict->bucketsCounter = newCap;
+    EmojicodeDictionary old = *dict;
+    dict->slots = newSlotso;
+    dict->capacity = capacity;
+    dict->growthLeft = dictionaryMaximumLoad(capacity) - dict->size;
+    writeBarrier(dicto, somethingObject(newSlotso));
+    
+    memset(dictionaryControl(dict), DICTIONARY_EMPTY, dictionaryControlSize(capacity));
     
-    Object **newBucko = newBuckoo->value;
-    if (oldBuckoo != NULL) {
-        for (int j = 0; j < oldCap; ++j) {
-            Object **oldBucko = oldBuckoo->value;
-            Object *eo = oldBucko[j];
-            if (eo != NULL) {
-                EmojicodeDictionaryNode *e = eo->value;
-                oldBucko[j] = NULL;
-                if (e->next == NULL) {
-                    newBucko[e->hash & (newCap - 1)] = eo;
-                }
-                else { // preserve order
-                    Object *loHeado = NULL, *loTailo = NULL;
-                    Object *hiHeado = NULL, *hiTailo = NULL;
-                    Object *nexto;
-                    do {
-                        e = eo->value;
-                        nexto = e->next;
-                        if ((e->hash & oldCap) == 0) {
-                            if (loTailo == NULL) {
-                                loHeado = eo;
-                            }
-                            else {
-                                EmojicodeDictionaryNode *loTail = loTailo->value;
-                                loTail->next = eo;
-                            }
-                            loTailo = eo;
-                        }
-                        else {
-                            if (hiTailo == NULL) {
-                                hiHeado = eo;
-                            }
-                            else {
-                                EmojicodeDictionaryNode *hiTail = hiTailo->value;
-                                hiTail->next = eo;
-                            }
-                            hiTailo = eo;
-                        }
-                    } while ((eo = nexto) != NULL);
-                    
-                    if (loTailo != NULL) {
-                        EmojicodeDictionaryNode *loTail = loTailo->value;
-                        loTail->next = NULL;
-                        newBucko[j] = loHeado;
-                    }
-                    if(hiTailo != NULL) {
-                        EmojicodeDictionaryNode *hiTail = hiTailo->value;
-                        hiTail->next = NULL;
-                        newBucko[j + oldCap] = hiHeado;
-                    }
-                }
+    if (old.slots != NULL) {
+        uint8_t *oldControl = dictionaryControl(&old);
+        EmojicodeDictionarySlot *oldSlots = dictionarySlots(&old);
+        EmojicodeDictionarySlot *slots = dictionarySlots(dict);
+        for (size_t i = 0; i < old.capacity; i++) {
+            if (!(oldControl[i] & 0x80)) {
+                size_t j = dictionaryFindInsertPosition(dict, oldSlots[i].hash);
+                dictionarySetControl(dict, j, oldControl[i]);
+                slots[j] = oldSlots[i];
             }
         }
     }
     return dicto;
 }
 
-void dictionaryPutVal(Object *dicto, Object *key, Something value, Thread *thread) {
-    EmojicodeDictionaryHash hash = dictionaryHash(dicto->value, key);
+void dictionaryPutVal(Object *dicto, Something key, Something value, Thread *thread) {
+    EmojicodeDictionary *dict = objectValue(dicto);
+    EmojicodeDictionaryHash hash = dictionaryHash(key);
     
-    EmojicodeDictionary *dict = dicto->value;
-    
-    if (dict->buckets == NULL || dict->bucketsCounter == 0) {
-        dicto = dictionaryResize(dicto, thread);
-        dict = dicto->value;
+    EmojicodeDictionarySlot *slot = dictionaryFindSlot(dict, hash, key);
+    if (slot != NULL) { // existing mapping for key
+        slot->value = value;
+        writeBarrier(dicto, value);
+        return;
     }
     
-    Object **bucko;
-    size_t n = 0, i = 0;
-    bucko = dict->buckets->value;
-    n = dict->bucketsCounter;
-    
-    Object *po;
-    
-    if ((po = bucko[i = (hash & (n - 1))]) == NULL) {
-        bucko[i] = dictionaryNewNode(&dicto, hash, key, value, NULL, thread);
-        dict = dicto->value;
-    }
-    else {
-        EmojicodeDictionaryNode *p = po->value;
-        Object *eo = NULL;
-        if (dictionaryKeyHashEqual(dict, hash, p->hash, key, p->key)) {
-            eo = po;
-        }
-        else {
-            for (int binCount = 0; ; ++binCount) {
-                if (p->next == NULL) {
-                    p->next = dictionaryNewNode(&dicto, hash, key, value, NULL, thread);
-                    dict = dicto->value;
-                    break;
-                }
-                EmojicodeDictionaryNode *e = p->next->value;
-                
-                if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                    break;
-                }
-                p = e;
-            }
-        }
-        if (eo != NULL) { // existing mapping for key
-            EmojicodeDictionaryNode *e = eo->value;
-            e->value = value;
-            return;
-        }
+    if (dict->growthLeft == 0) {
+        stackPush(dicto, 2, 0, thread);
+        stackSetVariable(0, key, thread);
+        stackSetVariable(1, value, thread);
+        dictionaryResize(stackGetThis(thread), thread);
+        dicto = stackGetThis(thread);
+        key = stackGetVariable(0, thread);
+        value = stackGetVariable(1, thread);
+        stackPop(thread);
+        dict = objectValue(dicto);
     }
-    if(++(dict->size) > dict->nextThreshold) {
-        dicto = dictionaryResize(dicto, thread);
-        dict = dicto->value;
+    
+    size_t i = dictionaryFindInsertPosition(dict, hash);
+    if (dictionaryControl(dict)[i] == DICTIONARY_EMPTY) {
+        dict->growthLeft--;
     }
+    dictionarySetControl(dict, i, h2(hash));
+    dictionarySlots(dict)[i] = (EmojicodeDictionarySlot){ key, value, hash };
+    dict->size++;
+    
+    writeBarrier(dicto, key);
+    writeBarrier(dicto, value);
 }
 
-EmojicodeDictionaryNode* dictionaryRemoveNode(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Object *key, Thread *thread){
-    size_t n = 0, index = 0;
-    if (dict->buckets != NULL && (n = dict->bucketsCounter) > 0) {
-        Object **bucko = dict->buckets->value;
-        Object *po = bucko[index = hash & (n - 1)];
-        if (po != NULL) {
-            EmojicodeDictionaryNode *p = po->value;
-            EmojicodeDictionaryNode *node = NULL;
-            if (dictionaryKeyHashEqual(dict, hash, p->hash, key, p->key)) {
-                node = p;
-            }
-            else {
-                Object *nexto = p->next;
-                while (nexto) {
-                    EmojicodeDictionaryNode *e = nexto->value;
-                    if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                        node = e;
-                        break;
-                    }
-                    p = e;
-                    nexto = e->next;
-                }
-            }
-            if(node != NULL) {
-                if (node == p) {
-                    bucko[index] = node->next;
-                }
-                else {
-                    p->next = node->next;
-                }
-                dict->size--;
-                return node;
-            }
-        }
+static void dictionaryRemoveSlot(EmojicodeDictionary *dict, EmojicodeDictionarySlot *slot){
+    uint8_t *control = dictionaryControl(dict);
+    size_t mask = dict->capacity - 1;
+    size_t i = slot - dictionarySlots(dict);
+    
+    //If no group that contains this slot was ever full, no probe went past it and it can become empty again
+    DictionaryGroupMask emptyAfter = groupMatch(control + i, DICTIONARY_EMPTY);
+    DictionaryGroupMask emptyBefore = groupMatch(control + ((i - DICTIONARY_GROUP_WIDTH) & mask), DICTIONARY_EMPTY);
+    bool wasNeverFull = emptyAfter && emptyBefore
+                        && groupFirst(emptyAfter) + (DICTIONARY_GROUP_WIDTH - 1 - groupLast(emptyBefore)) < DICTIONARY_GROUP_WIDTH;
+    
+    dictionarySetControl(dict, i, wasNeverFull ? DICTIONARY_EMPTY : DICTIONARY_DELETED);
+    if (wasNeverFull) {
+        dict->growthLeft++;
     }
-    return NULL;
+    *slot = (EmojicodeDictionarySlot){ NOTHINGNESS, NOTHINGNESS, 0 };
+    dict->size--;
 }
 
 
 // MARK: Bridge -> Dictionary interface
-void dictionaryRemove(EmojicodeDictionary *dict, Object *key, Thread *thread) {
-    dictionaryRemoveNode(dict, dictionaryHash(dict, key), key, thread);
+void dictionaryRemove(EmojicodeDictionary *dict, Something key, Thread *thread) {
+    EmojicodeDictionarySlot *slot = dictionaryFindSlot(dict, dictionaryHash(key), key);
+    if (slot != NULL) {
+        dictionaryRemoveSlot(dict, slot);
+    }
 }
 
-bool dictionaryContainsKey(EmojicodeDictionary *dict, Object *key) {
-    return dictionaryGetNode(dict, dictionaryHash(dict, key), key) != NULL;
+Something dictionaryLookup(EmojicodeDictionary *dict, Something key, Thread *thread) {
+    EmojicodeDictionarySlot *slot = dictionaryFindSlot(dict, dictionaryHash(key), key);
+    return slot ? slot->value : NOTHINGNESS;
+}
+
+bool dictionaryContainsKey(EmojicodeDictionary *dict, Something key) {
+    return dictionaryFindSlot(dict, dictionaryHash(key), key) != NULL;
 }
 
 void dictionaryClear(EmojicodeDictionary *dict) {
-    if (dict->buckets != NULL && dict->size > 0) {
-        EmojicodeDictionaryNode **buck = dict->buckets->value;
+    if (dict->slots != NULL && dict->size > 0) {
+        memset(dictionaryControl(dict), DICTIONARY_EMPTY, dictionaryControlSize(dict->capacity));
+        memset(dictionarySlots(dict), 0, dict->capacity * sizeof(EmojicodeDictionarySlot));
         dict->size = 0;
-        for (int i = 0; i < dict->bucketsCounter; ++i) {
-            buck[i] = NULL;
-        }
+        dict->growthLeft = dictionaryMaximumLoad(dict->capacity);
     }
 }
 
 void dictionaryInit(Thread *thread) {
-    EmojicodeDictionary *dict = stackGetThis(thread)->value;
-    dict->loadFactor = DICTIONARY_DEFAULT_LOAD_FACTOR;
+    EmojicodeDictionary *dict = objectValue(stackGetThis(thread));
+    dict->slots = NULL;
+    dict->capacity = 0;
     dict->size = 0;
-    dict->buckets = NULL;
-    dict->nextThreshold = 0;
+    dict->growthLeft = 0;
 }
 
 void dictionaryMark(Object *object) {
-    EmojicodeDictionary *dict = object->value;
+    EmojicodeDictionary *dict = objectValue(object);
     
-    if(dict->buckets == NULL){
+    if(dict->slots == NULL){
         return;
     }
-    mark(&dict->buckets);
-    
-    Object **buckets = dict->buckets->value;
-    for (size_t i = 0; i < dict->bucketsCounter; i++) {
-        Object **eo = &buckets[i];
-        while (*(eo)) {
-            mark(eo);
-            EmojicodeDictionaryNode *e = (*eo)->value;
-            mark(&(e->key));
-            if (isRealObject(e->value)){
-                mark(&(e->value.object));
+    mark(&dict->slots);
+    uint8_t *control = dictionaryControl(dict);
+    EmojicodeDictionarySlot *slots = dictionarySlots(dict);
+    for (size_t i = 0; i < dict->capacity; i++) {
+        if (!(control[i] & 0x80)) {
+            if (isRealObject(slots[i].key)){
+                mark(&slots[i].key.object);
+            }
+            if (isRealObject(slots[i].value)){
+                mark(&slots[i].value.object);
             }
-            eo = &(e->next);
         }
     }
 }
 
-void dictionarySet(Object *dicto, Object *key, Something value, Thread *thread){
+void dictionarySet(Object *dicto, Something key, Something value, Thread *thread){
     dictionaryPutVal(dicto, key, value, thread);
 }
 
+//MARK: Enumerators
+
+static Something dictionaryNewEnumerator(Class *class, Thread *thread) {
+    Object *enumerator = newObject(class);
+    EmojicodeDictionaryEnumerator *e = objectValue(enumerator);
+    e->dictionary = stackGetThis(thread);
+    writeBarrier(enumerator, somethingObject(e->dictionary));
+    return somethingObject(enumerator);
+}
+
+/** Returns the next slot with an item, at which the enumerator stops, or @c NULL if there are no more items. */
+static EmojicodeDictionarySlot* enumeratorPeek(EmojicodeDictionaryEnumerator *e) {
+    EmojicodeDictionary *dict = objectValue(e->dictionary);
+    if (dict->slots == NULL) {
+        return NULL;
+    }
+    uint8_t *control = dictionaryControl(dict);
+    while (e->index < dict->capacity) {
+        DictionaryGroupMask full = ~groupMatchEmptyOrDeleted(control + e->index)
+                                   & (DictionaryGroupMask)((1u << DICTIONARY_GROUP_WIDTH) - 1);
+        if (full) {
+            //Groups near the end contain the mirrored control bytes
+            if (e->index + groupFirst(full) >= dict->capacity) {
+                e->index = dict->capacity;
+                return NULL;
+            }
+            e->index += groupFirst(full);
+            return dictionarySlots(dict) + e->index;
+        }
+        e->index += DICTIONARY_GROUP_WIDTH;
+    }
+    return NULL;
+}
+
+/** Returns the next slot with an item and moves the enumerator behind it. */
+static EmojicodeDictionarySlot* enumeratorNext(EmojicodeDictionaryEnumerator *e) {
+    EmojicodeDictionarySlot *slot = enumeratorPeek(e);
+    if (slot) {
+        e->current = ++e->index;
+    }
+    return slot;
+}
+
+static Something bridgeEnumeratorNextKey(Thread *thread) {
+    EmojicodeDictionarySlot *slot = enumeratorNext(objectValue(stackGetThis(thread)));
+    return slot ? slot->key : NOTHINGNESS;
+}
+
+static Something bridgeEnumeratorNextValue(Thread *thread) {
+    EmojicodeDictionarySlot *slot = enumeratorNext(objectValue(stackGetThis(thread)));
+    return slot ? slot->value : NOTHINGNESS;
+}
+
+static Something bridgeEnumeratorMoreComing(Thread *thread) {
+    return enumeratorPeek(objectValue(stackGetThis(thread))) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+}
+
+static Something bridgeEnumeratorCurrentValue(Thread *thread) {
+    EmojicodeDictionaryEnumerator *e = objectValue(stackGetThis(thread));
+    EmojicodeDictionary *dict = objectValue(e->dictionary);
+    size_t i = e->current - 1;
+    if (e->current == 0 || i >= dict->capacity || dictionaryControl(dict)[i] & 0x80) {
+        return NOTHINGNESS;
+    }
+    return dictionarySlots(dict)[i].value;
+}
+
+void dictionaryEnumeratorMark(Object *enumerator) {
+    mark(&((EmojicodeDictionaryEnumerator *)objectValue(enumerator))->dictionary);
+}
+
+MethodHandler dictionaryEnumeratorMethodForName(EmojicodeChar cl, EmojicodeChar name) {
+    switch (name) {
+        case 0x1F53D: //🔽
+            return cl == 0x1F4A0 ? bridgeEnumeratorNextValue : bridgeEnumeratorNextKey;
+        case 0x2753: //❓
+            return bridgeEnumeratorMoreComing;
+        case 0x1F48E: //💎
+            return bridgeEnumeratorCurrentValue;
+    }
+    return NULL;
+}
+
 //MARK: Bridges
 
 static Something bridgeDictionarySet(Thread *thread) {
-    dictionarySet(stackGetThis(thread), stackGetVariable(0, thread).object, stackGetVariable(1, thread), thread);
+    dictionarySet(stackGetThis(thread), stackGetVariable(0, thread), stackGetVariable(1, thread), thread);
     return NOTHINGNESS;
 }
 
 static Something bridgeDictionaryGet(Thread *thread) {
-    Object *key = stackGetVariable(0, thread).object;
-    EmojicodeDictionaryNode *node = dictionaryGetNode(stackGetThis(thread)->value, dictionaryHash(stackGetThis(thread)->value, key), key);
-    if(node == NULL){
-        return NOTHINGNESS;
-    }
-    else {
-        return node->value;
-    }
+    return dictionaryLookup(objectValue(stackGetThis(thread)), stackGetVariable(0, thread), thread);
 }
 
 static Something bridgeDictionaryRemove(Thread *thread) {
-    dictionaryRemove(stackGetThis(thread)->value, stackGetVariable(0, thread).object, thread);
+    dictionaryRemove(objectValue(stackGetThis(thread)), stackGetVariable(0, thread), thread);
     return NOTHINGNESS;
 }
 
+static Something bridgeDictionaryCount(Thread *thread) {
+    return somethingInteger((EmojicodeInteger)((EmojicodeDictionary *)objectValue(stackGetThis(thread)))->size);
+}
+
+static Something bridgeDictionaryEntries(Thread *thread) {
+    return dictionaryNewEnumerator(CL_DICTIONARY_ENTRY_ENUMERATOR, thread);
+}
+
+static Something bridgeDictionaryValues(Thread *thread) {
+    return dictionaryNewEnumerator(CL_DICTIONARY_VALUE_ENUMERATOR, thread);
+}
+
 void bridgeDictionaryInit(Thread *thread) {
     dictionaryInit(thread);
 }
@@ -356,6 +511,14 @@ MethodHandler dictionaryMethodForName(EmojicodeChar name) {
             return bridgeDictionaryRemove;
         case 0x1F437: //🐷
             return bridgeDictionarySet;
+        case 0x1F414: //🐔
+            return bridgeDictionaryCount;
+        case 0x1F511: //🔑
+        case 0x1F3AB: //🎫
+        case 0x1F361: //🍡
+            return bridgeDictionaryEntries;
+        case 0x1F48E: //💎
+            return bridgeDictionaryValues;
     }
     return NULL;
 }
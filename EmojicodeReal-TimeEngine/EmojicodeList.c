@@ -8,18 +8,106 @@
 
 #include "EmojicodeList.h"
 #include "EmojicodeString.h"
+#include "Emojicode.h"
 
 #include <string.h>
 
-#define items(list) ((Something *)list->items->value)
+#define items(list) ((Something *)objectValue(list->items))
+#define integers(list) ((EmojicodeInteger *)objectValue(list->items))
+#define doubles(list) ((double *)objectValue(list->items))
+#define symbols(list) ((EmojicodeChar *)objectValue(list->items))
 
 void expandListSize(Thread *thread);
 
+/** Returns the size of one element of @c list in bytes. */
+static size_t elementSize(List *list){
+    switch (list->storage) {
+        case LIST_STORAGE_INTEGER:
+            return sizeof(EmojicodeInteger);
+        case LIST_STORAGE_DOUBLE:
+            return sizeof(double);
+        case LIST_STORAGE_SYMBOL:
+            return sizeof(EmojicodeChar);
+        default:
+            return sizeof(Something);
+    }
+}
+
+/** Whether @c o can be stored in @c list without converting the list to store Somethings. */
+static bool listCanStore(List *list, Something o){
+    switch (list->storage) {
+        case LIST_STORAGE_INTEGER:
+            return somethingType(o) == T_INTEGER;
+        case LIST_STORAGE_DOUBLE:
+            return somethingType(o) == T_DOUBLE;
+        case LIST_STORAGE_SYMBOL:
+            return somethingType(o) == T_SYMBOL;
+        default:
+            return true;
+    }
+}
+
+/** Stores @c o at @c i. @c o must be storable in this list. */
+static void listStore(List *list, size_t i, Something o){
+    switch (list->storage) {
+        case LIST_STORAGE_INTEGER:
+            integers(list)[i] = unwrapInteger(o);
+            return;
+        case LIST_STORAGE_DOUBLE:
+            doubles(list)[i] = unwrapDouble(o);
+            return;
+        case LIST_STORAGE_SYMBOL:
+            symbols(list)[i] = unwrapSymbol(o);
+            return;
+        default:
+            items(list)[i] = o;
+    }
+}
+
+/** Returns the element at @c i as Something. Might allocate an integer box. */
+static Something listLoad(List *list, size_t i){
+    switch (list->storage) {
+        case LIST_STORAGE_INTEGER:
+            return somethingInteger(integers(list)[i]);
+        case LIST_STORAGE_DOUBLE:
+            return somethingDouble(doubles(list)[i]);
+        case LIST_STORAGE_SYMBOL:
+            return somethingSymbol(symbols(list)[i]);
+        default:
+            return items(list)[i];
+    }
+}
+
+/**
+ * Converts the list that is this in the current stack frame to store Somethings.
+ * @warning GC-invoking
+ */
+static void listGeneralize(Thread *thread){
+    List *list = objectValue(stackGetThis(thread));
+    if (list->items && elementSize(list) < sizeof(Something)) {
+        Object *object = resizeArray(list->items, list->capacity * sizeof(Something));
+        list = objectValue(stackGetThis(thread));
+        list->items = object;
+        writeBarrier(stackGetThis(thread), somethingObject(object));
+    }
+    //The elements are converted backwards as they might grow and overwrite their successors
+    for (size_t i = list->count; i-- > 0;) {
+        //Integer boxes are allocated in the old generation and do not need the write barrier
+        Something o = listLoad(list, i);
+        items(list)[i] = o;
+    }
+    list->storage = LIST_STORAGE_SOMETHING;
+}
+
 void listMark(Object *self){
-    List *list = self->value;
+    List *list = objectValue(self);
     if (list->items) {
         mark(&list->items); 
     }
+    if (list->storage != LIST_STORAGE_SOMETHING) {
+        //Unboxed elements do not reference any objects
+        return;
+    }
     for (size_t i = 0; i < list->count; i++) {
         if(isRealObject(items(list)[i]))
            mark(&items(list)[i].object);
@@ -27,21 +115,36 @@ void listMark(Object *self){
 }
 
 void listAppend(Object *lo, Something o, Thread *thread){
-    stackPush(lo, 0, 0, thread);
-    List *list = lo->value;
-    if (list->capacity - list->count == 0) {
-        expandListSize(thread);
+    List *list = objectValue(lo);
+    if (list->capacity - list->count == 0 || !listCanStore(list, o)) {
+        stackPush(lo, 1, 0, thread);
+        stackSetVariable(0, o, thread);
+        if (!listCanStore(list, o)) {
+            listGeneralize(thread);
+        }
+        list = objectValue(stackGetThis(thread));
+        if (list->capacity - list->count == 0) {
+            expandListSize(thread);
+        }
+        lo = stackGetThis(thread);
+        o = stackGetVariable(0, thread);
+        stackPop(thread);
+        list = objectValue(lo);
+    }
+    if (list->storage == LIST_STORAGE_SOMETHING) {
+        items(list)[list->count++] = o;
+        writeBarrier(lo, o);
+    }
+    else {
+        listStore(list, list->count++, o);
     }
-    list = stackGetThis(thread)->value;
-    items(list)[list->count++] = o;
-    stackPop(thread);
 }
 
 Something listPop(List *list){
     if(list->count == 0){
         return NOTHINGNESS;
     }
-    Something o = items(list)[list->count - 1];
+    Something o = listLoad(list, list->count - 1);
     list->count--;
     return o;
 }
@@ -50,7 +153,9 @@ bool listRemoveByIndex(List *list, size_t index){
     if (list->count <= index){
         return false;
     }
-    memmove(items(list) + index, items(list) + index + 1, sizeof(Something) * (--list->count - index));
+    size_t size = elementSize(list);
+    Byte *bytes = objectValue(list->items);
+    memmove(bytes + index * size, bytes + (index + 1) * size, size * (--list->count - index));
     return true;
 }
 
@@ -58,66 +163,425 @@ Something listGet(List *list, size_t i){
     if (list->count <= i){
         return NOTHINGNESS;
     }
-    return items(list)[i];
+    return listLoad(list, i);
 }
 
 void expandListSize(Thread *thread){
 #define initialSize 7
-    List *list = stackGetThis(thread)->value;
+    List *list = objectValue(stackGetThis(thread));
     if (list->capacity == 0) {
-        Object *object = newArray(sizeof(Something) * initialSize);
-        list = stackGetThis(thread)->value;
+        Object *object = newArray(elementSize(list) * initialSize);
+        list = objectValue(stackGetThis(thread));
         list->items = object;
         list->capacity = initialSize;
+        writeBarrier(stackGetThis(thread), somethingObject(object));
     }
     else {
         size_t newSize = list->capacity + (list->capacity >> 1);
-        Object *object = resizeArray(list->items, newSize * sizeof(Something));
-        list = stackGetThis(thread)->value;
+        Object *object = resizeArray(list->items, newSize * elementSize(list));
+        list = objectValue(stackGetThis(thread));
         list->items = object;
         list->capacity = newSize;
+        writeBarrier(stackGetThis(thread), somethingObject(object));
     }
 #undef initialSize
 }
 
 bool listRemove(List *list, Something x){
-    if(x.type != T_OBJECT){
-        for(size_t i = 0; i < list->count; i++){
-            if(items(list)[i].type == x.type && items(list)[i].raw == x.raw){
+    if (!listCanStore(list, x)) {
+        return false;
+    }
+    if (list->storage == LIST_STORAGE_INTEGER) {
+        EmojicodeInteger integer = unwrapInteger(x);
+        for (size_t i = 0; i < list->count; i++) {
+            if (integers(list)[i] == integer) {
                 listRemoveByIndex(list, i);
                 return true;
             }
         }
+        return false;
     }
-    else {
-        for(size_t i = 0; i < list->count; i++){
-            if(items(list)[i].type == T_OBJECT && items(list)[i].object == x.object){
-                listRemoveByIndex(list, i);
-                return true;
-            }
+    
+    //Objects are compared by identity, integer boxes by value
+    bool box = isRealObject(x) && isIntegerBox(x.object);
+    for(size_t i = 0; i < list->count; i++){
+        if(box ? somethingPrimitivesEqual(items(list)[i], x) : listLoad(list, i).bits == x.bits){
+            listRemoveByIndex(list, i);
+            return true;
         }
     }
     
     return false;
 }
 
+/** Swaps the elements at @c a and @c b. */
+static void listSwap(List *list, size_t a, size_t b){
+    size_t size = elementSize(list);
+    Byte *bytes = objectValue(list->items);
+    Byte tmp[sizeof(Something)];
+    memcpy(tmp, bytes + a * size, size);
+    memcpy(bytes + a * size, bytes + b * size, size);
+    memcpy(bytes + b * size, tmp, size);
+}
+
 void listShuffleInPlace(List *list) {
     EmojicodeInteger i, j, n = (EmojicodeInteger)list->count;
-    Something tmp;
     
     for (i = n - 1; i > 0; i--) {
         j = secureRandomNumber(0, i);
-        tmp = items(list)[j];
-        items(list)[j] = items(list)[i];
-        items(list)[i] = tmp;
+        listSwap(list, j, i);
     }
 }
 
+/* MARK: Sorting */
+
+#define SORT_NAME(name) unboxedInteger ## name
+#define SORT_CONTEXT EmojicodeInteger *
+#define SORT_LESS(c, a, b) ((c)[a] < (c)[b])
+#define SORT_SWAP(c, a, b) do { EmojicodeInteger t = (c)[a]; (c)[a] = (c)[b]; (c)[b] = t; } while (0)
+#include "ListSort.h"
+
+#define SORT_NAME(name) unboxedDouble ## name
+#define SORT_CONTEXT double *
+#define SORT_LESS(c, a, b) ((c)[a] < (c)[b])
+#define SORT_SWAP(c, a, b) do { double t = (c)[a]; (c)[a] = (c)[b]; (c)[b] = t; } while (0)
+#define SORT_GUARDED
+#include "ListSort.h"
+
+#define SORT_NAME(name) unboxedSymbol ## name
+#define SORT_CONTEXT EmojicodeChar *
+#define SORT_LESS(c, a, b) ((c)[a] < (c)[b])
+#define SORT_SWAP(c, a, b) do { EmojicodeChar t = (c)[a]; (c)[a] = (c)[b]; (c)[b] = t; } while (0)
+#include "ListSort.h"
+
+#define swapSomethings(c, a, b) do { Something t = (c)[a]; (c)[a] = (c)[b]; (c)[b] = t; } while (0)
+
+#define SORT_NAME(name) integer ## name
+#define SORT_CONTEXT Something *
+#define SORT_LESS(c, a, b) (unwrapInteger((c)[a]) < unwrapInteger((c)[b]))
+#define SORT_SWAP swapSomethings
+#include "ListSort.h"
+
+#define SORT_NAME(name) double ## name
+#define SORT_CONTEXT Something *
+#define SORT_LESS(c, a, b) (unwrapDouble((c)[a]) < unwrapDouble((c)[b]))
+#define SORT_SWAP swapSomethings
+#define SORT_GUARDED
+#include "ListSort.h"
+
+//Symbols and booleans of the same type are ordered like their encodings
+#define SORT_NAME(name) encoding ## name
+#define SORT_CONTEXT Something *
+#define SORT_LESS(c, a, b) ((c)[a].bits < (c)[b].bits)
+#define SORT_SWAP swapSomethings
+#include "ListSort.h"
+
+#define SORT_NAME(name) string ## name
+#define SORT_CONTEXT Something *
+#define SORT_LESS(c, a, b) (stringCompare(objectValue((c)[a].object), objectValue((c)[b].object)) < 0)
+#define SORT_SWAP swapSomethings
+#include "ListSort.h"
+
+/**
+ * Calls the comparator, which is the first argument in the current stack frame, with the elements at @c a and @c b of
+ * the list, which is this in the current stack frame. The comparator might invoke the Garbage Collector, therefore
+ * the list is fetched again for every comparison.
+ */
+static bool comparatorLess(Thread *thread, size_t a, size_t b){
+    List *list = objectValue(stackGetThis(thread));
+    size_t count = list->count;
+    Something arguments[2] = { listLoad(list, a), listLoad(list, b) };
+    
+    Something order = executeCallableExtern(stackGetVariable(0, thread).object, arguments, thread);
+    
+    if (((List *)objectValue(stackGetThis(thread)))->count != count) {
+        error("The list was modified by the comparator while it was sorted.");
+    }
+    return unwrapInteger(order) < 0;
+}
+
+#define SORT_NAME(name) comparator ## name
+#define SORT_CONTEXT Thread *
+#define SORT_LESS comparatorLess
+#define SORT_SWAP(thread, a, b) listSwap(objectValue(stackGetThis(thread)), a, b)
+#define SORT_STABLE
+#define SORT_GUARDED
+#include "ListSort.h"
+
+/** Sorts a list of Somethings without a comparator. All elements must be integers, doubles, symbols or strings. */
+static void listSortSomethings(List *list){
+    if (list->count == 0) {
+        return;
+    }
+    
+    Something *elements = items(list);
+    Type type = somethingType(elements[0]);
+    for (size_t i = 0; i < list->count; i++) {
+        Type elementType = somethingType(elements[i]);
+        if (elementType != type || (type == T_OBJECT && (!elements[i].object || elements[i].object->class != CL_STRING))) {
+            error("🐑 can only sort lists whose elements are either all integers, doubles, symbols, booleans or strings.");
+        }
+    }
+    
+    switch (type) {
+        case T_INTEGER:
+            integerSort(elements, list->count);
+            return;
+        case T_DOUBLE:
+            doubleSort(elements, list->count);
+            return;
+        case T_OBJECT:
+            stringSort(elements, list->count);
+            return;
+        default:
+            encodingSort(elements, list->count);
+            return;
+    }
+}
+
+void listSort(List *list){
+    switch (list->storage) {
+        case LIST_STORAGE_INTEGER:
+            unboxedIntegerSort(integers(list), list->count);
+            return;
+        case LIST_STORAGE_DOUBLE:
+            unboxedDoubleSort(doubles(list), list->count);
+            return;
+        case LIST_STORAGE_SYMBOL:
+            unboxedSymbolSort(symbols(list), list->count);
+            return;
+        default:
+            listSortSomethings(list);
+            return;
+    }
+}
+
+//MARK: Parallel operations
+
+/**
+ * Whether @c callable should be called on the @c count elements of a list by the workers. This is only the case for
+ * closures that were proven to be allocation-free, as the Garbage Collector cannot run while workers are running.
+ */
+static bool listParallelizable(Object *callable, size_t count){
+    return callable->class == CL_CLOSURE && ((Closure *)objectValue(callable))->allocationFree && parallelWorthwhile(count);
+}
+
+/**
+ * Stores a new list, that can hold @c capacity elements of the given storage, into variable 1 of the current stack
+ * frame.
+ * @warning GC-invoking
+ */
+static void newResultList(ListStorage storage, size_t capacity, Thread *thread){
+    stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
+    List *result = objectValue(stackGetVariable(1, thread).object);
+    result->storage = storage;
+    if (capacity > 0) {
+        Object *itemsArray = newArray(elementSize(result) * capacity);
+        Object *resultObject = stackGetVariable(1, thread).object;
+        result = objectValue(resultObject);
+        result->items = itemsArray;
+        result->capacity = capacity;
+        writeBarrier(resultObject, somethingObject(itemsArray));
+    }
+}
+
+/** Converts @c list, which stores Somethings, to @c storage if all of its elements can be stored that way. */
+static void listNarrow(List *list, ListStorage storage){
+    List narrowed = { .storage = storage };
+    if (storage == LIST_STORAGE_SOMETHING) {
+        return;
+    }
+    for (size_t i = 0; i < list->count; i++) {
+        if (!listCanStore(&narrowed, items(list)[i])) {
+            return;
+        }
+    }
+    list->storage = storage;
+    //The elements are converted forwards as they shrink and only overwrite elements that were already converted
+    for (size_t i = 0; i < list->count; i++) {
+        listStore(list, i, items(list)[i]);
+    }
+}
+
+/** A map, filter or reduce run by the workers. As no collection can happen meanwhile, objects are referenced directly. */
+typedef struct {
+    List *list;
+    Object *callable;
+    /** The results of a map or the partial results of a reduce, which are stored per chunk. */
+    List *results;
+    /** The results of a filter. */
+    bool *selected;
+} ParallelListJob;
+
+static void mapChunk(void *context, size_t from, size_t to, size_t chunk, Thread *thread){
+    ParallelListJob *job = context;
+    for (size_t i = from; i < to; i++) {
+        Something argument = listLoad(job->list, i);
+        items(job->results)[i] = executeCallableExtern(job->callable, &argument, thread);
+    }
+}
+
+static void filterChunk(void *context, size_t from, size_t to, size_t chunk, Thread *thread){
+    ParallelListJob *job = context;
+    for (size_t i = from; i < to; i++) {
+        Something argument = listLoad(job->list, i);
+        job->selected[i] = unwrapBool(executeCallableExtern(job->callable, &argument, thread));
+    }
+}
+
+/** Reduces the chunk starting with its first element, which only requires the combining closure to be associative. */
+static void reduceChunk(void *context, size_t from, size_t to, size_t chunk, Thread *thread){
+    ParallelListJob *job = context;
+    Something arguments[2] = { listLoad(job->list, from) };
+    for (size_t i = from + 1; i < to; i++) {
+        arguments[1] = listLoad(job->list, i);
+        arguments[0] = executeCallableExtern(job->callable, arguments, thread);
+    }
+    items(job->results)[chunk] = arguments[0];
+}
+
+/**
+ * Calls the callable, which is variable 0 of the current stack frame, with every element of the list, which is this,
+ * and stores the results into the list in variable 1.
+ * @warning GC-invoking
+ */
+static void listMap(Thread *thread){
+    size_t count = ((List *)objectValue(stackGetThis(thread)))->count;
+    newResultList(LIST_STORAGE_SOMETHING, count, thread);
+    
+    if (listParallelizable(stackGetVariable(0, thread).object, count)) {
+        ParallelListJob job = {
+            objectValue(stackGetThis(thread)), stackGetVariable(0, thread).object,
+            objectValue(stackGetVariable(1, thread).object), NULL
+        };
+        parallelFor(count, parallelChunkSize(count), mapChunk, &job, thread);
+        job.results->count = count;
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            List *list = objectValue(stackGetThis(thread));
+            if (i >= list->count) {
+                break;
+            }
+            Something argument = listLoad(list, i);
+            Something value = executeCallableExtern(stackGetVariable(0, thread).object, &argument, thread);
+            
+            Object *resultObject = stackGetVariable(1, thread).object;
+            List *result = objectValue(resultObject);
+            items(result)[result->count++] = value;
+            writeBarrier(resultObject, value);
+        }
+    }
+    
+    Object *resultObject = stackGetVariable(1, thread).object;
+    List *result = objectValue(resultObject);
+    for (size_t i = 0; i < result->count; i++) {
+        writeBarrier(resultObject, items(result)[i]);
+    }
+    listNarrow(result, ((List *)objectValue(stackGetThis(thread)))->storage);
+}
+
+/**
+ * Stores all elements of the list, which is this, for which the callable, which is variable 0 of the current stack
+ * frame, returns true into a new list in variable 1.
+ * @warning GC-invoking
+ */
+static void listFilter(Thread *thread){
+    size_t count = ((List *)objectValue(stackGetThis(thread)))->count;
+    bool *selected = malloc(count ? count : 1);
+    if (!selected) {
+        error("Could not allocate memory for filtering.");
+    }
+    
+    if (listParallelizable(stackGetVariable(0, thread).object, count)) {
+        ParallelListJob job = { objectValue(stackGetThis(thread)), stackGetVariable(0, thread).object, NULL, selected };
+        parallelFor(count, parallelChunkSize(count), filterChunk, &job, thread);
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            List *list = objectValue(stackGetThis(thread));
+            if (i >= list->count) {
+                count = i;
+                break;
+            }
+            Something argument = listLoad(list, i);
+            selected[i] = unwrapBool(executeCallableExtern(stackGetVariable(0, thread).object, &argument, thread));
+        }
+        if (count > ((List *)objectValue(stackGetThis(thread)))->count) {
+            //The last call removed elements
+            count = ((List *)objectValue(stackGetThis(thread)))->count;
+        }
+    }
+    
+    size_t selectedCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        selectedCount += selected[i];
+    }
+    newResultList(((List *)objectValue(stackGetThis(thread)))->storage, selectedCount, thread);
+    
+    List *list = objectValue(stackGetThis(thread));
+    Object *resultObject = stackGetVariable(1, thread).object;
+    List *result = objectValue(resultObject);
+    size_t size = elementSize(list);
+    for (size_t i = 0; i < count; i++) {
+        if (selected[i]) {
+            memcpy((Byte *)objectValue(result->items) + result->count++ * size, (Byte *)objectValue(list->items) + i * size, size);
+            if (list->storage == LIST_STORAGE_SOMETHING) {
+                writeBarrier(resultObject, items(list)[i]);
+            }
+        }
+    }
+    free(selected);
+}
+
+/**
+ * Combines the elements of the list, which is this, with the callable, which is variable 0 of the current stack
+ * frame, starting with the initial value in variable 2. The result is stored into variable 2.
+ * @warning GC-invoking
+ */
+static void listReduce(Thread *thread){
+    size_t count = ((List *)objectValue(stackGetThis(thread)))->count;
+    
+    if (listParallelizable(stackGetVariable(0, thread).object, count)) {
+        size_t chunkSize = parallelChunkSize(count);
+        size_t chunks = (count + chunkSize - 1) / chunkSize;
+        newResultList(LIST_STORAGE_SOMETHING, chunks, thread);
+        
+        ParallelListJob job = {
+            objectValue(stackGetThis(thread)), stackGetVariable(0, thread).object,
+            objectValue(stackGetVariable(1, thread).object), NULL
+        };
+        parallelFor(count, chunkSize, reduceChunk, &job, thread);
+        job.results->count = chunks;
+        
+        Object *partialsObject = stackGetVariable(1, thread).object;
+        for (size_t i = 0; i < chunks; i++) {
+            writeBarrier(partialsObject, items(job.results)[i]);
+        }
+        
+        //The partial results are combined in order
+        for (size_t i = 0; i < chunks; i++) {
+            List *partials = objectValue(stackGetVariable(1, thread).object);
+            Something arguments[2] = { stackGetVariable(2, thread), items(partials)[i] };
+            stackSetVariable(2, executeCallableExtern(stackGetVariable(0, thread).object, arguments, thread), thread);
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            List *list = objectValue(stackGetThis(thread));
+            if (i >= list->count) {
+                break;
+            }
+            Something arguments[2] = { stackGetVariable(2, thread), listLoad(list, i) };
+            stackSetVariable(2, executeCallableExtern(stackGetVariable(0, thread).object, arguments, thread), thread);
+        }
+    }
+}
 
 /* MARK: Emoji bridges */
 
 static Something listCountBridge(Thread *thread){
-    return somethingInteger((EmojicodeInteger)((List *)stackGetThis(thread)->value)->count);
+    return somethingInteger((EmojicodeInteger)((List *)objectValue(stackGetThis(thread)))->count);
 }
 
 static Something listAppendBridge(Thread *thread){
@@ -131,50 +595,112 @@ static void constructEmptyListBridge(Thread *thread){
 }
 
 static Something listGetBridge(Thread *thread){
-    return listGet(stackGetThis(thread)->value, unwrapInteger(stackGetVariable(0, thread)));
+    return listGet(objectValue(stackGetThis(thread)), unwrapInteger(stackGetVariable(0, thread)));
 }
 
 static Something listRemoveBridge(Thread *thread){
-    return listRemoveByIndex(stackGetThis(thread)->value, unwrapInteger(stackGetVariable(0, thread))) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    return listRemoveByIndex(objectValue(stackGetThis(thread)), unwrapInteger(stackGetVariable(0, thread))) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
 static Something listPopBridge(Thread *thread){
-    return listPop(stackGetThis(thread)->value);
+    return listPop(objectValue(stackGetThis(thread)));
 }
 
 static Something listInsertBridge(Thread *thread){
-    List *list = stackGetThis(thread)->value;
+    List *list = objectValue(stackGetThis(thread));
+    if (!listCanStore(list, stackGetVariable(1, thread))) {
+        listGeneralize(thread);
+        list = objectValue(stackGetThis(thread));
+    }
     if (list->capacity - list->count == 0) {
         expandListSize(thread);
     }
     
-    list = stackGetThis(thread)->value;
+    list = objectValue(stackGetThis(thread));
     EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
     
-    memmove(items(list) + index + 1, items(list) + index, sizeof(Something) * (list->count++ - index));
-    items(list)[index] = stackGetVariable(1, thread);
+    size_t size = elementSize(list);
+    Byte *bytes = objectValue(list->items);
+    memmove(bytes + (index + 1) * size, bytes + index * size, size * (list->count++ - index));
+    listStore(list, index, stackGetVariable(1, thread));
+    writeBarrier(stackGetThis(thread), stackGetVariable(1, thread));
     
     return NOTHINGNESS;
 }
 
 static Something listFromListBridge(Thread *thread){
-    Object *listO = newObject(CL_LIST);
-    List *list = listO->value;
-    List *cpdList = stackGetThis(thread)->value;
+    stackPush(stackGetThis(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    List *original = objectValue(stackGetThis(thread));
+    Object *itemsArray = newArray(elementSize(original) * original->capacity);
+    
+    Object *listO = stackGetVariable(0, thread).object;
+    List *list = objectValue(listO);
+    List *cpdList = objectValue(stackGetThis(thread));
+    stackPop(thread);
     
     list->count = cpdList->count;
     list->capacity = cpdList->capacity;
-    list->items = newArray(sizeof(Something) * cpdList->capacity);
+    list->items = itemsArray;
+    list->storage = cpdList->storage;
+    writeBarrier(listO, somethingObject(itemsArray));
     
-    memcpy(items(list), items(cpdList), cpdList->count * sizeof(Something));
+    memcpy(objectValue(list->items), objectValue(cpdList->items), cpdList->count * elementSize(cpdList));
     return somethingObject(listO);
 }
 
+static Something listSortBridge(Thread *thread){
+    listSort(objectValue(stackGetThis(thread)));
+    return NOTHINGNESS;
+}
+
+static Something listSortWithComparatorBridge(Thread *thread){
+    comparatorSort(thread, ((List *)objectValue(stackGetThis(thread)))->count);
+    return NOTHINGNESS;
+}
+
+static Something listStableSortWithComparatorBridge(Thread *thread){
+    comparatorStableSort(thread, ((List *)objectValue(stackGetThis(thread)))->count);
+    return NOTHINGNESS;
+}
+
 static Something listShuffleInPlaceBridge(Thread *thread){
-    listShuffleInPlace(stackGetThis(thread)->value);
+    listShuffleInPlace(objectValue(stackGetThis(thread)));
     return NOTHINGNESS;
 }
 
+static Something listMapBridge(Thread *thread){
+    Something callable = stackGetVariable(0, thread);
+    stackPush(stackGetThis(thread), 2, 0, thread);
+    stackSetVariable(0, callable, thread);
+    listMap(thread);
+    Something result = stackGetVariable(1, thread);
+    stackPop(thread);
+    return result;
+}
+
+static Something listFilterBridge(Thread *thread){
+    Something callable = stackGetVariable(0, thread);
+    stackPush(stackGetThis(thread), 2, 0, thread);
+    stackSetVariable(0, callable, thread);
+    listFilter(thread);
+    Something result = stackGetVariable(1, thread);
+    stackPop(thread);
+    return result;
+}
+
+static Something listReduceBridge(Thread *thread){
+    Something initial = stackGetVariable(0, thread);
+    Something callable = stackGetVariable(1, thread);
+    stackPush(stackGetThis(thread), 3, 0, thread);
+    stackSetVariable(0, callable, thread);
+    stackSetVariable(2, initial, thread);
+    listReduce(thread);
+    Something result = stackGetVariable(2, thread);
+    stackPop(thread);
+    return result;
+}
+
 MethodHandler listMethodForName(EmojicodeChar method){
     switch (method) {
         case 0x1F43B: //bear
@@ -193,6 +719,18 @@ MethodHandler listMethodForName(EmojicodeChar method){
             return listShuffleInPlaceBridge;
         case 0x1F42E: //🐮
             return listFromListBridge;
+        case 0x1F411: //🐑
+            return listSortBridge;
+        case 0x1F981: //🦁
+            return listSortWithComparatorBridge;
+        case 0x1F418: //🐘
+            return listStableSortWithComparatorBridge;
+        case 0x1F406: //🐆
+            return listMapBridge;
+        case 0x1F405: //🐅
+            return listFilterBridge;
+        case 0x1F403: //🐃
+            return listReduceBridge;
     }
     return NULL;
 }
@@ -7,10 +7,16 @@
 //
 
 #include "EmojicodeString.h"
+#include "Emojicode.h"
 
 #include <string.h>
 #include "utf8.h"
 #include "EmojicodeList.h"
+#include "EmojicodeDictionary.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 bool stringEqual(String *a, String *b){
     if(a == b){
@@ -19,8 +25,237 @@ bool stringEqual(String *a, String *b){
     if(a->length != b->length){
         return false;
     }
+    if(a->length == 0){
+        return true;
+    }
+    //Equal strings are always stored alike
+    if(a->compact != b->compact){
+        return false;
+    }
+    if(a->hash && b->hash && a->hash != b->hash){
+        return false;
+    }
+    
+    return memcmp(stringStorage(a), stringStorage(b), stringStorageSize(a->length, a->compact)) == 0;
+}
+
+int stringCompare(String *a, String *b){
+    size_t length = a->length < b->length ? a->length : b->length;
+    if (a->compact && b->compact) {
+        //Latin-1 bytes are ordered like their code points
+        int result = memcmp(compactCharacters(a), compactCharacters(b), length);
+        if (result != 0) {
+            return result < 0 ? -1 : 1;
+        }
+    }
+    else {
+        for (size_t i = 0; i < length; i++) {
+            EmojicodeChar ca = stringCharacterAt(a, i), cb = stringCharacterAt(b, i);
+            if (ca != cb) {
+                return ca < cb ? -1 : 1;
+            }
+        }
+    }
+    return a->length < b->length ? -1 : a->length > b->length;
+}
+
+uint64_t stringHash(String *string){
+    if(string->hash){
+        return string->hash;
+    }
+    
+    uint64_t hash = string->length ? dictionaryHashBytes(stringStorage(string),
+                                                         stringStorageSize(string->length, string->compact))
+                                   : dictionaryHashBytes(NULL, 0);
+    //0 marks a hash that was not calculated yet
+    string->hash = hash ? hash : 1;
+    return string->hash;
+}
+
+EmojicodeChar* stringUTF32(String *string){
+    EmojicodeChar *utf32 = malloc(sizeof(EmojicodeChar) * (string->length ? string->length : 1));
+    for (EmojicodeInteger i = 0; i < string->length; i++) {
+        utf32[i] = stringCharacterAt(string, i);
+    }
+    return utf32;
+}
+
+void stringCopyCharacters(String *to, size_t offset, String *from){
+    if (to->compact == from->compact) {
+        memcpy(stringStorage(to) + stringStorageSize(offset, to->compact), stringStorage(from),
+               stringStorageSize(from->length, from->compact));
+    }
+    else {
+        EmojicodeChar *destination = wideCharacters(to) + offset;
+        uint8_t *source = compactCharacters(from);
+        for (EmojicodeInteger i = 0; i < from->length; i++) {
+            destination[i] = source[i];
+        }
+    }
+}
+
+/** Whether the @c length code points of @c b equal those of @c a starting at @c offset. */
+static bool stringRegionEqual(String *a, EmojicodeInteger offset, String *b){
+    if (a->compact == b->compact) {
+        return memcmp(stringStorage(a) + stringStorageSize(offset, a->compact), stringStorage(b),
+                      stringStorageSize(b->length, b->compact)) == 0;
+    }
+    for (EmojicodeInteger i = 0; i < b->length; i++) {
+        if (stringCharacterAt(a, offset + i) != stringCharacterAt(b, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//MARK: Searching
+
+/** Needles at least this long are searched with Boyer-Moore-Horspool, shorter ones with the prefilter. */
+#define horspoolMinimumLength 32
+
+/*
+ * The prefilter compares the first and the last code point of the needle with 16 bytes of the haystack at once and
+ * only compares the remaining code points at the positions where both matched. Boyer-Moore-Horspool skips up to the
+ * length of the needle at once, which pays off for long needles. Horspool looks code points up in a table of 256 shifts
+ * by their lowest byte, so that code points sharing their lowest byte get the smallest of their shifts.
+ */
+
+static EmojicodeInteger horspoolCompact(const uint8_t *haystack, size_t n, const uint8_t *needle, size_t m){
+    size_t shifts[256];
+    for (size_t i = 0; i < 256; i++) {
+        shifts[i] = m;
+    }
+    for (size_t i = 0; i < m - 1; i++) {
+        shifts[needle[i]] = m - 1 - i;
+    }
+    
+    for (size_t i = 0; i <= n - m; i += shifts[haystack[i + m - 1]]) {
+        if (haystack[i + m - 1] == needle[m - 1] && memcmp(haystack + i, needle, m - 1) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static EmojicodeInteger horspoolWide(const EmojicodeChar *haystack, size_t n, const EmojicodeChar *needle, size_t m){
+    size_t shifts[256];
+    for (size_t i = 0; i < 256; i++) {
+        shifts[i] = m;
+    }
+    for (size_t i = 0; i < m - 1; i++) {
+        shifts[needle[i] & 0xFF] = m - 1 - i;
+    }
+    
+    for (size_t i = 0; i <= n - m; i += shifts[haystack[i + m - 1] & 0xFF]) {
+        if (haystack[i + m - 1] == needle[m - 1] && memcmp(haystack + i, needle, (m - 1) * sizeof(EmojicodeChar)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** Returns the index of the first occurrence of @c needle in @c haystack or -1. @c m must be between 1 and @c n. */
+static EmojicodeInteger findCompact(const uint8_t *haystack, size_t n, const uint8_t *needle, size_t m){
+    if (m >= horspoolMinimumLength) {
+        return horspoolCompact(haystack, n, needle, m);
+    }
+    
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i first = _mm_set1_epi8((char)needle[0]);
+    __m128i last = _mm_set1_epi8((char)needle[m - 1]);
+    for (; i + 16 <= n - m + 1; i += 16) {
+        __m128i a = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i *)(haystack + i)));
+        __m128i b = _mm_cmpeq_epi8(last, _mm_loadu_si128((const __m128i *)(haystack + i + m - 1)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(a, b));
+        while (mask) {
+            size_t j = i + __builtin_ctz(mask);
+            if (m <= 2 || memcmp(haystack + j + 1, needle + 1, m - 2) == 0) {
+                return j;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i <= n - m; i++) {
+        if (haystack[i] == needle[0] && haystack[i + m - 1] == needle[m - 1] &&
+            (m <= 2 || memcmp(haystack + i + 1, needle + 1, m - 2) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** Returns the index of the first occurrence of @c needle in @c haystack or -1. @c m must be between 1 and @c n. */
+static EmojicodeInteger findWide(const EmojicodeChar *haystack, size_t n, const EmojicodeChar *needle, size_t m){
+    if (m >= horspoolMinimumLength) {
+        return horspoolWide(haystack, n, needle, m);
+    }
+    
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i first = _mm_set1_epi32((int)needle[0]);
+    __m128i last = _mm_set1_epi32((int)needle[m - 1]);
+    for (; i + 4 <= n - m + 1; i += 4) {
+        __m128i a = _mm_cmpeq_epi32(first, _mm_loadu_si128((const __m128i *)(haystack + i)));
+        __m128i b = _mm_cmpeq_epi32(last, _mm_loadu_si128((const __m128i *)(haystack + i + m - 1)));
+        uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(a, b)));
+        while (mask) {
+            size_t j = i + __builtin_ctz(mask);
+            if (m <= 2 || memcmp(haystack + j + 1, needle + 1, (m - 2) * sizeof(EmojicodeChar)) == 0) {
+                return j;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i <= n - m; i++) {
+        if (haystack[i] == needle[0] && haystack[i + m - 1] == needle[m - 1] &&
+            (m <= 2 || memcmp(haystack + i + 1, needle + 1, (m - 2) * sizeof(EmojicodeChar)) == 0)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Returns the code points of @c needle widened for searching the wide @c haystack, or @c NULL if @c stringFind can
+ * search for @c needle as it is stored. Callers widen the needle once and pass it to every @c stringFind call.
+ * @warning Do not forget to free the array.
+ */
+static EmojicodeChar* stringFindWidenNeedle(String *haystack, String *needle){
+    return !haystack->compact && needle->compact && needle->length > 0 ? stringUTF32(needle) : NULL;
+}
+
+/**
+ * Returns the index of the first occurrence of @c needle in @c haystack at or after @c from, or -1 if there is none.
+ * An empty needle is found at @c from. @c wideNeedle must be the result of @c stringFindWidenNeedle.
+ */
+static EmojicodeInteger stringFind(String *haystack, EmojicodeInteger from, String *needle,
+                                   const EmojicodeChar *wideNeedle){
+    if (from < 0 || needle->length > haystack->length - from) {
+        return -1;
+    }
+    if (needle->length == 0) {
+        return from;
+    }
     
-    return memcmp(a->characters->value, b->characters->value, a->length * sizeof(EmojicodeChar)) == 0;
+    size_t n = haystack->length - from, m = needle->length;
+    EmojicodeInteger index;
+    if (haystack->compact) {
+        //A needle that is not compact contains a code point no compact string contains
+        if (!needle->compact) {
+            return -1;
+        }
+        index = findCompact(compactCharacters(haystack) + from, n, compactCharacters(needle), m);
+    }
+    else if (needle->compact) {
+        index = findWide(wideCharacters(haystack) + from, n, wideNeedle, m);
+    }
+    else {
+        index = findWide(wideCharacters(haystack) + from, n, wideCharacters(needle), m);
+    }
+    return index < 0 ? -1 : index + from;
 }
 
 bool stringBeginsWith(String *a, String *with){
@@ -28,7 +263,7 @@ bool stringBeginsWith(String *a, String *with){
         return false;
     }
     
-    return memcmp(a->characters->value, with->characters->value, with->length * sizeof(EmojicodeChar)) == 0;
+    return stringRegionEqual(a, 0, with);
 }
 
 bool stringEndsWith(String *a, String *end){
@@ -36,14 +271,40 @@ bool stringEndsWith(String *a, String *end){
         return false;
     }
     
-    return memcmp(((EmojicodeChar*)a->characters->value) + (a->length - end->length), end->characters->value, end->length * sizeof(EmojicodeChar)) == 0;
+    return stringRegionEqual(a, a->length - end->length, end);
 }
 
-/** @warning GC-invoking */
-Object* stringSubstring(Object *stro, EmojicodeInteger from, EmojicodeInteger length, Thread *thread){
+/** Whether the code points of the string from @c from to @c from + @c length can be stored compactly. */
+static bool stringRegionFitsCompact(String *string, EmojicodeInteger from, EmojicodeInteger length){
+    if (string->compact) {
+        return true;
+    }
+    EmojicodeChar *characters = wideCharacters(string) + from;
+    for (EmojicodeInteger i = 0; i < length; i++) {
+        if (!characterFitsCompact(characters[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** The number of code points the characters object of @c string can hold. */
+static size_t stringCapacity(String *string){
+    return (string->characters->size - sizeof(Object)) / stringStorageSize(1, string->compact);
+}
+
+/**
+ * Like @c stringSubstring but the substring always shares the characters of @c stro if @c share is true and it can be
+ * stored like @c stro.
+ * @warning GC-invoking
+ */
+static Object* substring(Object *stro, EmojicodeInteger from, EmojicodeInteger length, bool share, Thread *thread){
     stackPush(stro, 1, 0, thread);
     {
-        String *string = stackGetThis(thread)->value;
+        String *string = objectValue(stackGetThis(thread));
+        if (from < 0){
+            from = 0;
+        }
         if (from >= string->length){
             length = 0;
             from = 0;
@@ -59,67 +320,208 @@ Object* stringSubstring(Object *stro, EmojicodeInteger from, EmojicodeInteger le
         }
     }
     
+    bool compact = stringRegionFitsCompact(objectValue(stackGetThis(thread)), from, length);
+    {
+        String *string = objectValue(stackGetThis(thread));
+        //A view must be stored like its string, as equal strings must be stored alike
+        if (compact == string->compact && (share || (size_t)length * substringViewRatio >= stringCapacity(string))) {
+            Object *ostro = newObject(CL_STRING);
+            string = objectValue(stackGetThis(thread));
+            
+            String *ostr = objectValue(ostro);
+            ostr->length = length;
+            ostr->characters = string->characters;
+            ostr->offset = string->offset + from;
+            ostr->compact = compact;
+            writeBarrier(ostro, somethingObject(string->characters));
+            
+            stackPop(thread);
+            return ostro;
+        }
+    }
+    
     stackSetVariable(0, somethingObject(newObject(CL_STRING)), thread);
-    Object *co = newArray(length * sizeof(EmojicodeChar));
+    Object *co = newArray(stringStorageSize(length, compact));
     
     Object *ostro = stackGetVariable(0, thread).object;
-    String *ostr = ostro->value;
+    String *ostr = objectValue(ostro);
     
     ostr->length = length;
     ostr->characters = co;
+    ostr->compact = compact;
+    writeBarrier(ostro, somethingObject(co));
     
-    memcpy(ostr->characters->value, characters((String *)stackGetThis(thread)->value) + from, length * sizeof(EmojicodeChar));
+    String *string = objectValue(stackGetThis(thread));
+    if (string->compact) {
+        memcpy(compactCharacters(ostr), compactCharacters(string) + from, length);
+    }
+    else if (compact) {
+        for (EmojicodeInteger i = 0; i < length; i++) {
+            compactCharacters(ostr)[i] = (uint8_t)wideCharacters(string)[from + i];
+        }
+    }
+    else {
+        memcpy(wideCharacters(ostr), wideCharacters(string) + from, length * sizeof(EmojicodeChar));
+    }
     
     stackPop(thread);
     return ostro;
 }
 
-void initStringFromSymbolList(Object *string, List *list){
-    String *str = string->value;
+Object* stringSubstring(Object *stro, EmojicodeInteger from, EmojicodeInteger length, Thread *thread){
+    return substring(stro, from, length, false, thread);
+}
+
+/** @warning GC-invoking */
+void initStringFromSymbolList(Object *string, Object *listObject, Thread *thread){
+    List *list = objectValue(listObject);
+    bool compact = true;
+    for (size_t i = 0; i < list->count; i++) {
+        if (!characterFitsCompact(unwrapSymbol(listGet(list, i)))) {
+            compact = false;
+            break;
+        }
+    }
     
+    stackPush(string, 1, 0, thread);
+    stackSetVariable(0, somethingObject(listObject), thread);
+    Object *co = newArray(stringStorageSize(list->count, compact));
+    string = stackGetThis(thread);
+    list = objectValue(stackGetVariable(0, thread).object);
+    stackPop(thread);
+    
+    String *str = objectValue(string);
     size_t count = list->count;
     str->length = count;
-    str->characters = newArray(count * sizeof(EmojicodeChar));
+    str->characters = co;
+    str->compact = compact;
+    str->hash = 0;
+    writeBarrier(string, somethingObject(co));
     
-    for (size_t i = 0; i < count; i++) {
-        characters(str)[i] = (EmojicodeChar)listGet(list, i).raw;
+    if (compact) {
+        for (size_t i = 0; i < count; i++) {
+            compactCharacters(str)[i] = (uint8_t)unwrapSymbol(listGet(list, i));
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            wideCharacters(str)[i] = unwrapSymbol(listGet(list, i));
+        }
     }
 }
 
 //MARK: Converting from C strings
 
-char* stringToChar(String *str){
-    //Size needed for UTF8 representation
-    size_t ds = u8_codingsize(characters(str), str->length);
-    //Allocate space for the UTF8 string
-    char *utf8str = malloc(ds + 1);
-    //Convert
-    size_t written = u8_toutf8(utf8str, ds, characters(str), str->length);
+char* stringToUTF8(String *str, size_t *length){
+    size_t written;
+    char *utf8str;
+    if (str->compact) {
+        size_t ds = u8_latin1codingsize(compactCharacters(str), str->length);
+        utf8str = malloc(ds + 1);
+        written = u8_fromlatin1(utf8str, ds, compactCharacters(str), str->length);
+    }
+    else {
+        size_t ds = u8_codingsize(wideCharacters(str), str->length);
+        utf8str = malloc(ds + 1);
+        written = u8_toutf8(utf8str, ds, wideCharacters(str), str->length);
+    }
     utf8str[written] = 0;
+    if (length) {
+        *length = written;
+    }
     return utf8str;
 }
 
-Object* stringFromChar(const char *cstring){
-    EmojicodeInteger len = u8_strlen(cstring);
+char* stringToChar(String *str){
+    return stringToUTF8(str, NULL);
+}
+
+/**
+ * Stores the @c count code points encoded by the valid UTF8 bytes in @c string. @c compact must tell whether all of
+ * them fit into the compact storage.
+ * @warning GC-invoking
+ */
+static void initStringFromValidUTF8(Object *string, const char *bytes, size_t length, size_t count, bool compact,
+                                    Thread *thread){
+    stackPush(string, 0, 0, thread);
+    Object *co = newArray(stringStorageSize(count, compact));
+    string = stackGetThis(thread);
+    stackPop(thread);
     
-    if(len == 0){
-        return emptyString;
+    String *str = objectValue(string);
+    str->length = count;
+    str->characters = co;
+    str->compact = compact;
+    str->hash = 0;
+    writeBarrier(string, somethingObject(co));
+    
+    if (compact) {
+        u8_tolatin1(compactCharacters(str), count, bytes, length);
+    }
+    else {
+        u8_toucs(wideCharacters(str), count, bytes, length);
+    }
+}
+
+void initStringFromUTF8(Object *string, const char *bytes, size_t length, Thread *thread){
+    size_t count;
+    int latin1;
+    if (u8_validate(bytes, length, &count, &latin1)) {
+        initStringFromValidUTF8(string, bytes, length, count, latin1, thread);
+        return;
     }
     
-    Object *stro = newObject(CL_STRING);
-    String *string = stro->value;
-    string->length = len;
-    string->characters = newArray(len * sizeof(EmojicodeChar));
+    //Invalid sequences are decoded as U+FFFD, so the code points are only known after decoding them
+    EmojicodeChar *codePoints = malloc(sizeof(EmojicodeChar) * length);
+    count = u8_toucs(codePoints, length, bytes, length);
+    bool compact = true;
+    for (size_t i = 0; i < count; i++) {
+        compact = compact && characterFitsCompact(codePoints[i]);
+    }
     
-    u8_toucs(characters(string), len, cstring, strlen(cstring));
+    stackPush(string, 0, 0, thread);
+    Object *co = newArray(stringStorageSize(count, compact));
+    string = stackGetThis(thread);
+    stackPop(thread);
     
+    String *str = objectValue(string);
+    str->length = count;
+    str->characters = co;
+    str->compact = compact;
+    str->hash = 0;
+    writeBarrier(string, somethingObject(co));
+    
+    for (size_t i = 0; i < count; i++) {
+        if (compact) {
+            compactCharacters(str)[i] = (uint8_t)codePoints[i];
+        }
+        else {
+            wideCharacters(str)[i] = codePoints[i];
+        }
+    }
+    free(codePoints);
+}
+
+Object* stringFromUTF8(const char *bytes, size_t length){
+    if(length == 0){
+        return emptyString;
+    }
+    
+    stackPush(newObject(CL_STRING), 0, 0, currentThread);
+    initStringFromUTF8(stackGetThis(currentThread), bytes, length, currentThread);
+    Object *stro = stackGetThis(currentThread);
+    stackPop(currentThread);
     return stro;
 }
 
+Object* stringFromChar(const char *cstring){
+    return stringFromUTF8(cstring, strlen(cstring));
+}
+
 //MARK: Bridges
 
 static Something stringPrintStdoutBrigde(Thread *thread){
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     char *utf8str = stringToChar(string);
     printf("%s\n", utf8str);
     free(utf8str);
@@ -127,15 +529,15 @@ static Something stringPrintStdoutBrigde(Thread *thread){
 }
 
 static Something stringEqualBridge(Thread *thread){
-    String *a = stackGetThis(thread)->value;
-    String *b = stackGetVariable(0, thread).object->value;
+    String *a = objectValue(stackGetThis(thread));
+    String *b = objectValue(stackGetVariable(0, thread).object);
     return stringEqual(a, b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
 static Something stringSubstringBridge(Thread *thread){
     EmojicodeInteger from = unwrapInteger(stackGetVariable(0, thread));
     EmojicodeInteger length = unwrapInteger(stackGetVariable(1, thread));
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     
     if (from < 0) {
         from = (EmojicodeInteger)string->length + from;
@@ -148,43 +550,74 @@ static Something stringSubstringBridge(Thread *thread){
 }
 
 static Something stringSearchBridge(Thread *thread){
-    String *string = stackGetThis(thread)->value;
-    String *search = stackGetVariable(0, thread).object->value;
-    
-    for (EmojicodeInteger i = 0; i < string->length; ++i){
-        bool found = true;
-        for (EmojicodeInteger j = 0; j < search->length; ++j) {
-            if (characters(string)[i + j] != characters(search)[j]) {
-                found = false;
-                break;
-            }
-        }
-        
-        if (found) {
-            return somethingInteger(i);
+    String *string = objectValue(stackGetThis(thread));
+    String *search = objectValue(stackGetVariable(0, thread).object);
+    
+    EmojicodeChar *wideSearch = stringFindWidenNeedle(string, search);
+    EmojicodeInteger index = stringFind(string, 0, search, wideSearch);
+    free(wideSearch);
+    return index < 0 ? NOTHINGNESS : somethingInteger(index);
+}
+
+static Something stringSearchAllBridge(Thread *thread){
+    Something sp = stackGetVariable(0, thread);
+    
+    stackPush(stackGetThis(thread), 2, 0, thread);
+    stackSetVariable(0, sp, thread);
+    stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
+    
+    //The widened search string is not moved by the Garbage Collector
+    EmojicodeChar *wideSearch = stringFindWidenNeedle(objectValue(stackGetThis(thread)),
+                                                      objectValue(stackGetVariable(0, thread).object));
+    EmojicodeInteger index = 0;
+    while (true) {
+        String *search = objectValue(stackGetVariable(0, thread).object);
+        index = stringFind(objectValue(stackGetThis(thread)), index, search, wideSearch);
+        if (index < 0) {
+            break;
         }
-        
+        listAppend(stackGetVariable(1, thread).object, somethingInteger(index), thread);
+        search = objectValue(stackGetVariable(0, thread).object);
+        index += search->length ? search->length : 1;
     }
-    return NOTHINGNESS;
+    free(wideSearch);
+    
+    Something list = stackGetVariable(1, thread);
+    stackPop(thread);
+    return list;
+}
+
+static Something stringCountBridge(Thread *thread){
+    String *string = objectValue(stackGetThis(thread));
+    String *search = objectValue(stackGetVariable(0, thread).object);
+    
+    EmojicodeChar *wideSearch = stringFindWidenNeedle(string, search);
+    EmojicodeInteger count = 0;
+    for (EmojicodeInteger index = 0; (index = stringFind(string, index, search, wideSearch)) >= 0; count++) {
+        index += search->length ? search->length : 1;
+    }
+    free(wideSearch);
+    return somethingInteger(count);
 }
 
 static Something stringTrimBridge(Thread *thread){
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     
     EmojicodeInteger start = 0;
     EmojicodeInteger stop = string->length - 1;
     
-    while(start < string->length && isWhitespace(characters(string)[start]))
+    EmojicodeChar c;
+    while(start < string->length && (c = stringCharacterAt(string, start), isWhitespace(c)))
         start++;
     
-    while(stop > 0 && isWhitespace(characters(string)[stop]))
+    while(stop > 0 && (c = stringCharacterAt(string, stop), isWhitespace(c)))
         stop--;
     
     return somethingObject(stringSubstring(stackGetThis(thread), start, stop - start + 1, thread));
 }
 
 static void stringGetInput(Thread *thread){ //TODO: remove? or at least improve
-    String *prompt = stackGetVariable(0, thread).object->value;
+    String *prompt = objectValue(stackGetVariable(0, thread).object);
     char *utf8str = stringToChar(prompt);
     printf("%s\n", utf8str);
     fflush(stdout);
@@ -208,13 +641,7 @@ static void stringGetInput(Thread *thread){ //TODO: remove? or at least improve
         buffer = realloc(buffer, bufferSize);
     }
 
-    EmojicodeInteger len = u8_strlen(buffer);
-    
-    String *string = stackGetThis(thread)->value;
-    string->length = len;
-    
-    string->characters = newArray(len * sizeof(EmojicodeChar));
-    u8_toucs(characters(string), len, buffer, strlen(buffer));
+    initStringFromUTF8(stackGetThis(thread), buffer, strlen(buffer), thread);
     
     free(buffer); 
 }
@@ -226,44 +653,33 @@ static Something stringSplitByStringBridge(Thread *thread){
     stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
     stackSetVariable(0, sp, thread);
     
-    EmojicodeInteger firstOfSeperator = 0, seperatorIndex = 0, firstAfterSeperator = 0;
+    EmojicodeInteger firstAfterSeperator = 0;
+    //The widened separator is not moved by the Garbage Collector
+    EmojicodeChar *wideSeparator = stringFindWidenNeedle(objectValue(stackGetThis(thread)),
+                                                         objectValue(stackGetVariable(0, thread).object));
     
-    for (EmojicodeInteger i = 0, l = ((String *)stackGetThis(thread)->value)->length; i < l; i++) {
-        Object *stringObject = stackGetThis(thread);
-        Object *separatorObject = stackGetVariable(0, thread).object;
-        String *separator = (String *)separatorObject->value;
-        if(characters((String *)stringObject->value)[i] == characters(separator)[seperatorIndex]){
-            if (seperatorIndex == 0) {
-                firstOfSeperator = i;
-            }
-            
-            //Full seperator found
-            if(firstOfSeperator + separator->length == i + 1){
-                Object *stro;
-                if(firstAfterSeperator == firstOfSeperator){
-                    stro = emptyString;
-                }
-                else {
-                    stro = stringSubstring(stringObject, firstAfterSeperator, i - firstAfterSeperator - separator->length + 1, thread);
-                }
-                listAppend(stackGetVariable(1, thread).object, somethingObject(stro), thread);
-                seperatorIndex = 0;
-                firstAfterSeperator = i + 1;
-            }
-            else {
-                seperatorIndex++;
-            }
+    while (true) {
+        String *separator = objectValue(stackGetVariable(0, thread).object);
+        if (separator->length == 0) {
+            break;
         }
-        else if(seperatorIndex > 0){ //and not matching
-            seperatorIndex = 0;
-            //We search from the begin of the last partial match
-            i = firstOfSeperator;
+        EmojicodeInteger index = stringFind(objectValue(stackGetThis(thread)), firstAfterSeperator, separator,
+                                            wideSeparator);
+        if (index < 0) {
+            break;
         }
+        
+        Object *stro = substring(stackGetThis(thread), firstAfterSeperator, index - firstAfterSeperator, true, thread);
+        listAppend(stackGetVariable(1, thread).object, somethingObject(stro), thread);
+        separator = objectValue(stackGetVariable(0, thread).object);
+        firstAfterSeperator = index + separator->length;
     }
+    free(wideSeparator);
     
     Object *stringObject = stackGetThis(thread);
-    String *string = (String *)stringObject->value;
-    listAppend(stackGetVariable(1, thread).object, somethingObject(stringSubstring(stringObject, firstAfterSeperator, string->length - firstAfterSeperator, thread)), thread);
+    String *string = (String *)objectValue(stringObject);
+    Object *stro = substring(stringObject, firstAfterSeperator, string->length - firstAfterSeperator, true, thread);
+    listAppend(stackGetVariable(1, thread).object, somethingObject(stro), thread);
     
     Something list = stackGetVariable(1, thread);
     stackPop(thread);
@@ -271,48 +687,62 @@ static Something stringSplitByStringBridge(Thread *thread){
 }
 
 static Something stringLengthBridge(Thread *thread){
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     return somethingInteger((EmojicodeInteger)string->length);
 }
 
 static Something stringUTF8LengthBridge(Thread *thread){
-    String *str = stackGetThis(thread)->value;
-    return somethingInteger((EmojicodeInteger)u8_codingsize(str->characters->value, str->length - 1));
+    String *str = objectValue(stackGetThis(thread));
+    if (str->compact) {
+        return somethingInteger((EmojicodeInteger)u8_latin1codingsize(compactCharacters(str), str->length));
+    }
+    return somethingInteger((EmojicodeInteger)u8_codingsize(wideCharacters(str), str->length));
 }
 
 static Something stringByAppendingSymbolBridge(Thread *thread){
-    Object *co = newArray((((String *)stackGetThis(thread)->value)->length + 1) * sizeof(EmojicodeChar));
-    String *string = stackGetThis(thread)->value;
+    EmojicodeChar symbol = unwrapSymbol(stackGetVariable(0, thread));
+    bool compact = ((String *)objectValue(stackGetThis(thread)))->compact && characterFitsCompact(symbol);
     
-    Object *ostro = newObject(CL_STRING);
-    String *ostr = ostro->value;
+    stackPush(stackGetThis(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_STRING)), thread);
+    Object *co = newArray(stringStorageSize(((String *)objectValue(stackGetThis(thread)))->length + 1, compact));
+    String *string = objectValue(stackGetThis(thread));
+    Object *ostro = stackGetVariable(0, thread).object;
+    stackPop(thread);
     
+    String *ostr = objectValue(ostro);
     ostr->length = string->length + 1;
     ostr->characters = co;
+    ostr->compact = compact;
+    writeBarrier(ostro, somethingObject(co));
     
-    memcpy(characters(ostr), characters(string), string->length * sizeof(EmojicodeChar));
-    
-    characters(ostr)[string->length] = unwrapSymbol(stackGetVariable(0, thread));
+    stringCopyCharacters(ostr, 0, string);
+    if (compact) {
+        compactCharacters(ostr)[string->length] = (uint8_t)symbol;
+    }
+    else {
+        wideCharacters(ostr)[string->length] = symbol;
+    }
     
     return somethingObject(ostro);
 }
 
 static Something stringSymbolAtBridge(Thread *thread){
     EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
-    String *str = stackGetThis(thread)->value;
-    if(index >= str->length){
+    String *str = objectValue(stackGetThis(thread));
+    if(index < 0 || index >= str->length){
         return NOTHINGNESS;
     }
     
-    return somethingInteger(characters(str)[index]);
+    return somethingSymbol(stringCharacterAt(str, index));
 }
 
 static Something stringBeginsWithBridge(Thread *thread){
-    return stringBeginsWith(stackGetThis(thread)->value, stackGetVariable(0, thread).object->value) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    return stringBeginsWith(objectValue(stackGetThis(thread)), objectValue(stackGetVariable(0, thread).object)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
 static Something stringEndsWithBridge(Thread *thread){
-    return stringEndsWith(stackGetThis(thread)->value, stackGetVariable(0, thread).object->value) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+    return stringEndsWith(objectValue(stackGetThis(thread)), objectValue(stackGetVariable(0, thread).object)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
 static Something stringSplitBySymbolBridge(Thread *thread){
@@ -322,17 +752,19 @@ static Something stringSplitBySymbolBridge(Thread *thread){
     
     EmojicodeInteger from = 0;
     
-    for (EmojicodeInteger i = 0, l = ((String *)stackGetThis(thread)->value)->length; i < l; i++) {
+    for (EmojicodeInteger i = 0, l = ((String *)objectValue(stackGetThis(thread)))->length; i < l; i++) {
         Object *stringObject = stackGetThis(thread);
-        if (characters((String *)stringObject->value)[i] == separator) {
-            listAppend(stackGetVariable(0, thread).object, somethingObject(stringSubstring(stringObject, from, i - from, thread)), thread);
+        if (stringCharacterAt(objectValue(stringObject), i) == separator) {
+            Object *stro = substring(stringObject, from, i - from, true, thread);
+            listAppend(stackGetVariable(0, thread).object, somethingObject(stro), thread);
             from = i + 1;
         }
         
     }
 
     Object *stringObject = stackGetThis(thread);
-    listAppend(stackGetVariable(0, thread).object, somethingObject(stringSubstring(stringObject, from, ((String *) stringObject->value)->length - from, thread)), thread);
+    Object *stro = substring(stringObject, from, ((String *) objectValue(stringObject))->length - from, true, thread);
+    listAppend(stackGetVariable(0, thread).object, somethingObject(stro), thread);
     
     Something list = stackGetVariable(0, thread);
     stackPop(thread);
@@ -340,23 +772,28 @@ static Something stringSplitBySymbolBridge(Thread *thread){
 }
 
 static Something stringToData(Thread *thread){
-    char *s = stringToChar(stackGetThis(thread)->value);
+    size_t length;
+    char *s = stringToUTF8(objectValue(stackGetThis(thread)), &length);
     
     Object *o = newObject(CL_DATA);
-    Data *d = o->value;
-    d->length = strlen(s);
+    Data *d = objectValue(o);
+    d->length = length;
     d->bytes = s;
     return somethingObject(o);
 }
 
 static Something stringToCharacterList(Thread *thread){
-    String *str = stackGetThis(thread)->value;
-    Object *list = newObject(CL_LIST);
+    stackPush(stackGetThis(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    ((List *)objectValue(stackGetVariable(0, thread).object))->storage = LIST_STORAGE_SYMBOL;
     
-    for (size_t i = 0; i < str->length; i++) {
-        listAppend(list, somethingSymbol(characters(str)[i]), thread);
+    for (size_t i = 0; i < ((String *)objectValue(stackGetThis(thread)))->length; i++) {
+        String *str = objectValue(stackGetThis(thread));
+        listAppend(stackGetVariable(0, thread).object, somethingSymbol(stringCharacterAt(str, i)), thread);
     }
-    return somethingObject(list);
+    Something list = stackGetVariable(0, thread);
+    stackPop(thread);
+    return list;
 }
 
 static Something stringJSON(Thread *thread){
@@ -364,19 +801,23 @@ static Something stringJSON(Thread *thread){
 }
 
 static void stringFromSymbolListBridge(Thread *thread){
-    initStringFromSymbolList(stackGetThis(thread), stackGetVariable(0, thread).object->value);
+    initStringFromSymbolList(stackGetThis(thread), stackGetVariable(0, thread).object, thread);
 }
 
 static void stringFromStringList(Thread *thread) {
     size_t stringSize = 0;
     size_t appendLocation = 0;
+    bool compact;
     
     {
-        List *list = stackGetVariable(0, thread).object->value;
-        String *glue = stackGetVariable(1, thread).object->value;
+        List *list = objectValue(stackGetVariable(0, thread).object);
+        String *glue = objectValue(stackGetVariable(1, thread).object);
+        compact = list->count < 2 || glue->compact;
         
         for (size_t i = 0; i < list->count; i++) {
-            stringSize += ((String *)listGet(list, i).object->value)->length;
+            String *aString = objectValue(listGet(list, i).object);
+            stringSize += aString->length;
+            compact = compact && aString->compact;
         }
         
         if (list->count > 0){
@@ -384,22 +825,25 @@ static void stringFromStringList(Thread *thread) {
         }
     }
         
-    Object *co = newArray(stringSize * sizeof(EmojicodeChar));
+    Object *co = newArray(stringStorageSize(stringSize, compact));
     
     {
-        List *list = stackGetVariable(0, thread).object->value;
-        String *glue = stackGetVariable(1, thread).object->value;
+        List *list = objectValue(stackGetVariable(0, thread).object);
+        String *glue = objectValue(stackGetVariable(1, thread).object);
         
-        String *string = stackGetThis(thread)->value;
+        String *string = objectValue(stackGetThis(thread));
         string->length = stringSize;
         string->characters = co;
+        string->compact = compact;
+        string->hash = 0;
+        writeBarrier(stackGetThis(thread), somethingObject(co));
         
         for (size_t i = 0; i < list->count; i++) {
-            String *aString = listGet(list, i).object->value;
-            memcpy(characters(string) + appendLocation, characters(aString), aString->length * sizeof(EmojicodeChar));
+            String *aString = objectValue(listGet(list, i).object);
+            stringCopyCharacters(string, appendLocation, aString);
             appendLocation += aString->length;
             if(i + 1 < list->count){
-                memcpy(characters(string) + appendLocation, characters(glue), glue->length * sizeof(EmojicodeChar));
+                stringCopyCharacters(string, appendLocation, glue);
                 appendLocation += glue->length;
             }
         }
@@ -407,60 +851,303 @@ static void stringFromStringList(Thread *thread) {
 }
 
 static void stringFromSymbol(Thread *thread){
-    Object *co = newArray(sizeof(EmojicodeChar));
+    EmojicodeChar symbol = unwrapSymbol(stackGetVariable(0, thread));
+    bool compact = characterFitsCompact(symbol);
+    Object *co = newArray(stringStorageSize(1, compact));
     
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     string->length = 1;
     string->characters = co;
+    string->compact = compact;
+    string->hash = 0;
+    writeBarrier(stackGetThis(thread), somethingObject(co));
     
-    ((EmojicodeChar *)string->characters->value)[0] = (EmojicodeChar)stackGetVariable(0, thread).raw;
+    if (compact) {
+        compactCharacters(string)[0] = (uint8_t)symbol;
+    }
+    else {
+        wideCharacters(string)[0] = symbol;
+    }
 }
 
-static void stringFromInteger(Thread *thread){
-    EmojicodeInteger base = stackGetVariable(1, thread).raw;
-    EmojicodeInteger n = stackGetVariable(0, thread).raw, a = llabs(n);
-    bool negative = n < 0;
+/** Enough room for any integer in any base including the sign. */
+#define integerDigitsMaximum 66
+#define integerBaseMinimum 2
+#define integerBaseMaximum 36
+
+/** Raises an error unless @c base is between @c integerBaseMinimum and @c integerBaseMaximum. */
+static void checkIntegerBase(EmojicodeInteger base){
+    if (base < integerBaseMinimum || base > integerBaseMaximum) {
+        error("Integers can only be written in bases between %d and %d, but %lld was given.", integerBaseMinimum,
+              integerBaseMaximum, (long long)base);
+    }
+}
+
+/**
+ * Writes the digits of @c n in @c base to the end of @c buffer and returns the first one. @c base must have been
+ * checked with @c checkIntegerBase.
+ */
+static char* formatInteger(char buffer[integerDigitsMaximum], EmojicodeInteger n, EmojicodeInteger base){
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    uint64_t a = n < 0 ? -(uint64_t)n : (uint64_t)n;
     
-    EmojicodeInteger d = negative ? 2 : 1;
-    while (n /= base) d++;
+    char *characters = buffer + integerDigitsMaximum;
+    do
+        *--characters = digits[a % base];
+    while (a /= base);
     
-    Object *co = newArray(d * sizeof(EmojicodeChar));
+    if (n < 0) *--characters = '-';
+    return characters;
+}
+
+static void stringFromInteger(Thread *thread){
+    EmojicodeInteger base = unwrapInteger(stackGetVariable(1, thread));
+    checkIntegerBase(base);
+    char buffer[integerDigitsMaximum];
+    char *digits = formatInteger(buffer, unwrapInteger(stackGetVariable(0, thread)), base);
+    EmojicodeInteger d = buffer + integerDigitsMaximum - digits;
+    
+    Object *co = newArray(stringStorageSize(d, true));
     
-    String *string = stackGetThis(thread)->value;
+    String *string = objectValue(stackGetThis(thread));
     string->length = d;
     string->characters = co;
+    string->compact = true;
+    string->hash = 0;
+    writeBarrier(stackGetThis(thread), somethingObject(co));
     
-    EmojicodeChar *characters = characters(string) + d;
-    do
-        *--characters = '0' + (int)(a % base);
-    while (a /= base);
-    
-    if (negative) characters[-1] = '-';
+    memcpy(compactCharacters(string), digits, d);
 }
 
 static void stringFromData(Thread *thread){
-    Data *data = stackGetVariable(0, thread).object->value;
-    if (!u8_isvalid(data->bytes, data->length)) {
-        stackGetThis(thread)->value = NULL;
+    Data *data = objectValue(stackGetVariable(0, thread).object);
+    size_t count;
+    int latin1;
+    if (!u8_validate(data->bytes, data->length, &count, &latin1)) {
+        failInitializer(thread);
         return;
     }
     
-    EmojicodeInteger len = u8_strlen(data->bytes);
-    Object *characters = newArray(len * sizeof(EmojicodeChar));
+    //The bytes are not moved by the Garbage Collector
+    initStringFromValidUTF8(stackGetThis(thread), data->bytes, data->length, count, latin1, thread);
+}
+
+void stringMark(Object *self){
+    if(((String *)objectValue(self))->characters){
+        mark(&((String *)objectValue(self))->characters);
+    }
+}
+
+//MARK: String Builder
+
+/**
+ * Makes room for @c count more code points in the string builder @c this. The code points can be stored compactly if
+ * @c compact is true.
+ * @warning GC-invoking
+ */
+static void stringBuilderReserve(EmojicodeInteger count, bool compact, Thread *thread){
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    bool widen = builder->compact && !compact;
+    EmojicodeInteger required = builder->length + count;
+    if (required <= builder->capacity && !widen && !builder->shared) {
+        return;
+    }
     
-    String *string = stackGetThis(thread)->value;
-    string->length = len;
-    string->characters = characters;
+    EmojicodeInteger capacity = builder->capacity;
+    if (required > capacity) {
+        capacity += capacity >> 1;
+        if (capacity < required) {
+            capacity = required < 16 ? 16 : required;
+        }
+    }
+    compact = builder->compact && compact;
     
-    data = stackGetVariable(0, thread).object->value;
+    if (builder->characters && !builder->shared) {
+        Object *characters = resizeArray(builder->characters, stringStorageSize(capacity, compact));
+        builder = objectValue(stackGetThis(thread));
+        builder->characters = characters;
+        writeBarrier(stackGetThis(thread), somethingObject(characters));
+        if (widen) {
+            //The code points are widened backwards as they would overwrite their successors otherwise
+            uint8_t *source = objectValue(characters);
+            EmojicodeChar *destination = objectValue(characters);
+            for (EmojicodeInteger i = builder->length; i-- > 0;) {
+                destination[i] = source[i];
+            }
+        }
+    }
+    else {
+        //A string returned by 🔡 shares the characters, which must therefore not change anymore
+        Object *characters = newArray(stringStorageSize(capacity, compact));
+        builder = objectValue(stackGetThis(thread));
+        if (builder->length > 0) {
+            String target = { .characters = characters, .compact = compact };
+            String source = { .length = builder->length, .characters = builder->characters, .compact = builder->compact };
+            stringCopyCharacters(&target, 0, &source);
+        }
+        builder->characters = characters;
+        builder->shared = false;
+        writeBarrier(stackGetThis(thread), somethingObject(characters));
+    }
+    builder->capacity = capacity;
+    builder->compact = compact;
+}
+
+/** Appends the ASCII characters @c bytes to the string builder @c this. @warning GC-invoking */
+static void stringBuilderAppendASCII(const char *bytes, size_t length, Thread *thread){
+    stringBuilderReserve(length, true, thread);
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    if (builder->compact) {
+        memcpy((uint8_t *)objectValue(builder->characters) + builder->length, bytes, length);
+    }
+    else {
+        EmojicodeChar *characters = (EmojicodeChar *)objectValue(builder->characters) + builder->length;
+        for (size_t i = 0; i < length; i++) {
+            characters[i] = (unsigned char)bytes[i];
+        }
+    }
+    builder->length += length;
+}
+
+static void stringBuilderInit(Thread *thread){
+    ((StringBuilder *)objectValue(stackGetThis(thread)))->compact = true;
+}
+
+static void stringBuilderInitWithCapacity(Thread *thread){
+    stringBuilderInit(thread);
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        stringBuilderReserve(capacity, true, thread);
+    }
+}
+
+static Something stringBuilderReserveBridge(Thread *thread){
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > builder->length) {
+        stringBuilderReserve(capacity - builder->length, builder->compact, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendString(Thread *thread){
+    String *string = objectValue(stackGetVariable(0, thread).object);
+    stringBuilderReserve(string->length, string->compact, thread);
     
-    u8_toucs(characters(string), len, data->bytes, data->length);
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    string = objectValue(stackGetVariable(0, thread).object);
+    String target = { .characters = builder->characters, .compact = builder->compact };
+    stringCopyCharacters(&target, builder->length, string);
+    builder->length += string->length;
+    return NOTHINGNESS;
 }
 
-void stringMark(Object *self){
-    if(((String *)self->value)->characters){
-        mark(&((String *)self->value)->characters);
+static Something stringBuilderAppendSymbol(Thread *thread){
+    EmojicodeChar symbol = unwrapSymbol(stackGetVariable(0, thread));
+    stringBuilderReserve(1, characterFitsCompact(symbol), thread);
+    
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    if (builder->compact) {
+        ((uint8_t *)objectValue(builder->characters))[builder->length++] = (uint8_t)symbol;
+    }
+    else {
+        ((EmojicodeChar *)objectValue(builder->characters))[builder->length++] = symbol;
+    }
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendInteger(Thread *thread){
+    EmojicodeInteger base = unwrapInteger(stackGetVariable(1, thread));
+    checkIntegerBase(base);
+    char buffer[integerDigitsMaximum];
+    char *digits = formatInteger(buffer, unwrapInteger(stackGetVariable(0, thread)), base);
+    stringBuilderAppendASCII(digits, buffer + integerDigitsMaximum - digits, thread);
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendDouble(Thread *thread){
+    double d = unwrapDouble(stackGetVariable(0, thread));
+    char buffer[32];
+    //The shortest of the two representations that reads back as the same double
+    int length = snprintf(buffer, sizeof(buffer), "%.15g", d);
+    if (strtod(buffer, NULL) != d) {
+        length = snprintf(buffer, sizeof(buffer), "%.17g", d);
+    }
+    stringBuilderAppendASCII(buffer, length, thread);
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderLength(Thread *thread){
+    return somethingInteger(((StringBuilder *)objectValue(stackGetThis(thread)))->length);
+}
+
+static Something stringBuilderToString(Thread *thread){
+    StringBuilder *builder = objectValue(stackGetThis(thread));
+    if (builder->length == 0) {
+        return somethingObject(emptyString);
     }
+    
+    Object *stro = newObject(CL_STRING);
+    builder = objectValue(stackGetThis(thread));
+    String *string = objectValue(stro);
+    string->length = builder->length;
+    string->compact = builder->compact;
+    
+    if ((size_t)builder->length * substringViewRatio >= (size_t)builder->capacity) {
+        string->characters = builder->characters;
+        builder->shared = true;
+        writeBarrier(stro, somethingObject(builder->characters));
+        return somethingObject(stro);
+    }
+    
+    stackPush(stackGetThis(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(stro), thread);
+    Object *characters = newArray(stringStorageSize(string->length, string->compact));
+    builder = objectValue(stackGetThis(thread));
+    stro = stackGetVariable(0, thread).object;
+    stackPop(thread);
+    
+    string = objectValue(stro);
+    string->characters = characters;
+    writeBarrier(stro, somethingObject(characters));
+    memcpy(objectValue(characters), objectValue(builder->characters), stringStorageSize(string->length, string->compact));
+    return somethingObject(stro);
+}
+
+void stringBuilderMark(Object *self){
+    if(((StringBuilder *)objectValue(self))->characters){
+        mark(&((StringBuilder *)objectValue(self))->characters);
+    }
+}
+
+MethodHandler stringBuilderMethodForName(EmojicodeChar name){
+    switch (name) {
+        case 0x1F371: //🍱
+            return stringBuilderReserveBridge;
+        case 0x1F43B: //🐻
+            return stringBuilderAppendString;
+        case 0x1F4DD: //📝
+            return stringBuilderAppendSymbol;
+        case 0x1F682: //🚂
+            return stringBuilderAppendInteger;
+        case 0x1F680: //🚀
+            return stringBuilderAppendDouble;
+        case 0x1F4CF: //📏
+            return stringBuilderLength;
+        case 0x1F521: //🔡
+            return stringBuilderToString;
+    }
+    return NULL;
+}
+
+InitializerHandler stringBuilderInitializerForName(EmojicodeChar name){
+    switch (name) {
+        case 0x1F195: //🆕
+            return stringBuilderInit;
+        case 0x1F371: //🍱
+            return stringBuilderInitWithCapacity;
+    }
+    return NULL;
 }
 
 MethodHandler stringMethodForName(EmojicodeChar name){
@@ -479,6 +1166,10 @@ MethodHandler stringMethodForName(EmojicodeChar name){
             return stringSubstringBridge;
         case 0x1F50D: //🔍
             return stringSearchBridge;
+        case 0x1F50E: //🔎
+            return stringSearchAllBridge;
+        case 0x1F522: //🔢
+            return stringCountBridge;
         case 0x1F527: //🔧
             return stringTrimBridge;
         case 0x1F52B: //🔫
@@ -0,0 +1,641 @@
+//
+//  JIT.c
+//  Emojicode
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "Emojicode.h"
+#include <string.h>
+#include <stddef.h>
+
+bool jitEnabled = false;
+
+#if defined(__x86_64__)
+
+#include <sys/mman.h>
+#include <pthread.h>
+
+/** The hotness at which a procedure is compiled. */
+static uint32_t jitThreshold = 1000;
+
+/*
+ * A baseline compiler which translates the pre-decoded instructions of a procedure into x86-64 machine code.
+ *
+ * Only procedures consisting entirely of literals, local variable access, integer, double and boolean operators,
+ * ifs, loops and returns are compiled. The generated code only calls back into the Real-Time Engine to box and unbox
+ * integers that do not fit into a Something and to stop at a safepoint at the end of a loop iteration, see
+ * @c safepointRequested. Every expression leaves its
+ * encoded Something in rax. The variables of the stack frame are addressed relative to rbx, which holds the first
+ * argument passed to the JITFunction.
+ */
+
+#define variableOffset(index) ((int32_t)((index) * sizeof(Something)))
+
+typedef struct {
+    Instruction *instruction;
+    Instruction *end;
+    Byte *code;
+    size_t length;
+    size_t capacity;
+    /** The number of values the generated code pushed onto the native stack, needed to align it for calls. */
+    size_t depth;
+    bool failed;
+} JITCompiler;
+/** Returns the opcode whose implementation is @c handler or 0 if the handler is not a known instruction. */
+static EmojicodeCoin opcodeForHandler(const void *handler){
+    static const void *handlers[0x100];
+    static bool initialized = false;
+
+    if (!initialized) {
+        for (EmojicodeCoin i = 0; i < 0x100; i++) {
+            handlers[i] = instructionHandler(i);
+        }
+        initialized = true;
+    }
+
+    if (handler == handlers[0]) {
+        return 0;
+    }
+    for (EmojicodeCoin i = 1; i < 0x100; i++) {
+        if (handlers[i] == handler) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+static Instruction jitConsumeInstruction(JITCompiler *c){
+    if (c->instruction >= c->end) {
+        c->failed = true;
+        return (Instruction){ .coin = 0 };
+    }
+    return *(c->instruction++);
+}
+
+static void emitBytes(JITCompiler *c, const Byte *bytes, size_t count){
+    if (c->length + count > c->capacity) {
+        c->capacity = (c->capacity + count) * 2;
+        c->code = realloc(c->code, c->capacity);
+        if (!c->code) {
+            error("Could not allocate memory for the JIT.");
+        }
+    }
+    memcpy(c->code + c->length, bytes, count);
+    c->length += count;
+}
+
+#define emit(c, ...) do { const Byte bytes[] = { __VA_ARGS__ }; emitBytes(c, bytes, sizeof(bytes)); } while (0)
+
+static void emit32(JITCompiler *c, uint32_t value){
+    emitBytes(c, (Byte *)&value, sizeof(value));
+}
+
+static void emit64(JITCompiler *c, uint64_t value){
+    emitBytes(c, (Byte *)&value, sizeof(value));
+}
+
+/** Emits a relative jump with the given opcode bytes and returns the position of its displacement. */
+static size_t emitJump(JITCompiler *c, const Byte *opcode, size_t opcodeLength){
+    emitBytes(c, opcode, opcodeLength);
+    size_t displacement = c->length;
+    emit32(c, 0);
+    return displacement;
+}
+
+static size_t emitJumpIfNotTrue(JITCompiler *c){
+    emit(c, 0xA8, 0x01); // test al, 1
+    return emitJump(c, (Byte[]){ 0x0F, 0x84 }, 2); // jz
+}
+
+static size_t emitJumpForward(JITCompiler *c){
+    return emitJump(c, (Byte[]){ 0xE9 }, 1); // jmp
+}
+
+/** Makes the jump whose displacement is at @c displacement jump to @c target. */
+static void patchJump(JITCompiler *c, size_t displacement, size_t target){
+    int32_t relative = (int32_t)(target - (displacement + 4));
+    memcpy(c->code + displacement, &relative, sizeof(relative));
+}
+
+static void emitJumpBackward(JITCompiler *c, size_t target){
+    patchJump(c, emitJumpForward(c), target);
+}
+
+static void emitValue(JITCompiler *c, uint64_t value){
+    emit(c, 0x48, 0xB8); // mov rax, imm64
+    emit64(c, value);
+}
+
+static void emitNothingness(JITCompiler *c){
+    emit(c, 0x31, 0xC0); // xor eax, eax
+}
+
+static void emitPush(JITCompiler *c){
+    emit(c, 0x50); // push rax
+    c->depth++;
+}
+
+/** Pops the value pushed last into @c rcx. */
+static void emitPopRcx(JITCompiler *c){
+    emit(c, 0x59); // pop rcx
+    c->depth--;
+}
+
+/** Calls @c function, whose arguments must already be in rdi and rsi, with a correctly aligned stack. */
+static void emitCall(JITCompiler *c, void *function){
+    //The return address and rbx were pushed on entry, which keeps the stack aligned as long as depth is even
+    if (c->depth % 2) {
+        emit(c, 0x48, 0x83, 0xEC, 0x08); // sub rsp, 8
+    }
+    emit(c, 0x49, 0xBB); // mov r11, imm64
+    emit64(c, (uint64_t)(uintptr_t)function);
+    emit(c, 0x41, 0xFF, 0xD3); // call r11
+    if (c->depth % 2) {
+        emit(c, 0x48, 0x83, 0xC4, 0x08); // add rsp, 8
+    }
+}
+
+static void emitReturn(JITCompiler *c){
+    emit(c, 0x5B); // pop rbx
+    emit(c, 0xC3); // ret
+}
+
+static EmojicodeInteger jitUnboxInteger(Object *box){
+    return unboxInteger(box);
+}
+
+static Object* jitBoxInteger(EmojicodeInteger i){
+    return boxInteger(i);
+}
+
+static void jitSafepoint(){
+    safepoint(currentThread);
+}
+
+static bool jitIntegerBoxesEqual(Object *a, Object *b){
+    return somethingPrimitivesEqual(somethingObject(a), somethingObject(b));
+}
+
+/** Replaces the integer Something in rax with its value. */
+static void emitUnwrapInteger(JITCompiler *c){
+    emit(c, 0x48, 0x89, 0xC2); // mov rdx, rax
+    emit(c, 0x48, 0xC1, 0xEA, 0x33); // shr rdx, 51
+    emit(c, 0x81, 0xFA); // cmp edx, imm32
+    emit32(c, 0x1FFF);
+    size_t boxed = emitJump(c, (Byte[]){ 0x0F, 0x85 }, 2); // jne
+    emit(c, 0x48, 0xC1, 0xE0, 0x0D); // shl rax, 13
+    emit(c, 0x48, 0xC1, 0xF8, 0x0D); // sar rax, 13
+    size_t done = emitJumpForward(c);
+    patchJump(c, boxed, c->length);
+    emit(c, 0x48, 0x89, 0xC7); // mov rdi, rax
+    emitCall(c, (void *)jitUnboxInteger);
+    patchJump(c, done, c->length);
+}
+
+/** Replaces the integer in rax with a Something, boxing it if it does not fit. */
+static void emitSomethingInteger(JITCompiler *c){
+    emit(c, 0x48, 0x89, 0xC1); // mov rcx, rax
+    emit(c, 0x48, 0xC1, 0xE1, 0x0D); // shl rcx, 13
+    emit(c, 0x48, 0xC1, 0xF9, 0x0D); // sar rcx, 13
+    emit(c, 0x48, 0x39, 0xC1); // cmp rcx, rax
+    size_t boxed = emitJump(c, (Byte[]){ 0x0F, 0x85 }, 2); // jne
+    emit(c, 0x48, 0xC1, 0xE0, 0x0D); // shl rax, 13
+    emit(c, 0x48, 0xC1, 0xE8, 0x0D); // shr rax, 13
+    emit(c, 0x48, 0xB9); // mov rcx, imm64
+    emit64(c, SOMETHING_INTEGER_TAG);
+    emit(c, 0x48, 0x09, 0xC8); // or rax, rcx
+    size_t done = emitJumpForward(c);
+    patchJump(c, boxed, c->length);
+    emit(c, 0x48, 0x89, 0xC7); // mov rdi, rax
+    emitCall(c, (void *)jitBoxInteger);
+    patchJump(c, done, c->length);
+}
+
+/** Replaces the double in xmm0 with a Something in rax. */
+static void emitSomethingDouble(JITCompiler *c){
+    emit(c, 0x66, 0x48, 0x0F, 0x7E, 0xC0); // movq rax, xmm0
+    emit(c, 0x66, 0x0F, 0x2E, 0xC0); // ucomisd xmm0, xmm0
+    emit(c, 0x7B, 0x0A); // jnp over the next instruction
+    emitValue(c, SOMETHING_CANONICAL_NAN);
+    emit(c, 0x48, 0xB9); // mov rcx, imm64
+    emit64(c, SOMETHING_DOUBLE_OFFSET);
+    emit(c, 0x48, 0x01, 0xC8); // add rax, rcx
+}
+
+/** Converts the condition code into a boolean Something. */
+static void emitBooleanFromFlags(JITCompiler *c, Byte setcc){
+    emit(c, 0x0F, setcc, 0xC0); // setcc al
+    emit(c, 0x0F, 0xB6, 0xC0); // movzx eax, al
+    emit(c, 0x48, 0xB9); // mov rcx, imm64
+    emit64(c, SOMETHING_BOOLEAN_TAG);
+    emit(c, 0x48, 0x09, 0xC8); // or rax, rcx
+}
+
+static void compileExpression(JITCompiler *c);
+
+/** Compiles two operands. The first one is left in rax, the second one in rcx. */
+static void compileOperands(JITCompiler *c){
+    compileExpression(c);
+    emitPush(c);
+    compileExpression(c);
+    emitPopRcx(c);
+    emit(c, 0x48, 0x91); // xchg rax, rcx
+}
+
+/** Compiles two integer operands and unwraps them. The first one is left in rax, the second one in rcx. */
+static void compileIntegerOperands(JITCompiler *c){
+    compileExpression(c);
+    emitUnwrapInteger(c);
+    emitPush(c);
+    compileExpression(c);
+    emitUnwrapInteger(c);
+    emitPopRcx(c);
+    emit(c, 0x48, 0x91); // xchg rax, rcx
+}
+
+static void compileIntegerComparison(JITCompiler *c, Byte setcc){
+    compileIntegerOperands(c);
+    emit(c, 0x48, 0x39, 0xC8); // cmp rax, rcx
+    emitBooleanFromFlags(c, setcc);
+}
+
+/** Compiles the comparison of two primitives, which are equal if they have the same bits or are equal boxes. */
+static void compilePrimitiveEquality(JITCompiler *c){
+    compileOperands(c);
+    emit(c, 0x48, 0x39, 0xC8); // cmp rax, rcx
+    size_t equal = emitJump(c, (Byte[]){ 0x0F, 0x84 }, 2); // je
+    emit(c, 0x48, 0x89, 0xC7); // mov rdi, rax
+    emit(c, 0x48, 0x89, 0xCE); // mov rsi, rcx
+    emit(c, 0x31, 0xC0); // xor eax, eax
+    emit(c, 0x48, 0x89, 0xFA); // mov rdx, rdi
+    emit(c, 0x48, 0xC1, 0xEA, 0x30); // shr rdx, 48
+    size_t notBox = emitJump(c, (Byte[]){ 0x0F, 0x85 }, 2); // jnz
+    emit(c, 0x48, 0x85, 0xFF); // test rdi, rdi
+    size_t nothingness = emitJump(c, (Byte[]){ 0x0F, 0x84 }, 2); // jz
+    emitCall(c, (void *)jitIntegerBoxesEqual);
+    size_t done = emitJumpForward(c);
+    patchJump(c, equal, c->length);
+    emit(c, 0xB8); // mov eax, imm32
+    emit32(c, 1);
+    patchJump(c, notBox, c->length);
+    patchJump(c, nothingness, c->length);
+    patchJump(c, done, c->length);
+    emit(c, 0x0F, 0xB6, 0xC0); // movzx eax, al
+    emit(c, 0x48, 0xB9); // mov rcx, imm64
+    emit64(c, SOMETHING_BOOLEAN_TAG);
+    emit(c, 0x48, 0x09, 0xC8); // or rax, rcx
+}
+
+/** Compiles two double operands. The first one is left in xmm0, the second one in xmm1. */
+static void compileDoubleOperands(JITCompiler *c){
+    compileOperands(c);
+    emit(c, 0x48, 0xBA); // mov rdx, imm64
+    emit64(c, SOMETHING_DOUBLE_OFFSET);
+    emit(c, 0x48, 0x29, 0xD0); // sub rax, rdx
+    emit(c, 0x48, 0x29, 0xD1); // sub rcx, rdx
+    emit(c, 0x66, 0x48, 0x0F, 0x6E, 0xC0); // movq xmm0, rax
+    emit(c, 0x66, 0x48, 0x0F, 0x6E, 0xC9); // movq xmm1, rcx
+}
+
+static void compileDoubleOperation(JITCompiler *c, Byte operation){
+    compileDoubleOperands(c);
+    emit(c, 0xF2, 0x0F, operation, 0xC1); // op xmm0, xmm1
+    emitSomethingDouble(c);
+}
+
+/**
+ * Compiles a double comparison. Unordered operands compare false like in C, which is why @c a < @c b is
+ * compiled as @c b > @c a.
+ */
+static void compileDoubleComparison(JITCompiler *c, bool swapped, Byte setcc){
+    compileDoubleOperands(c);
+    if (swapped) {
+        emit(c, 0x66, 0x0F, 0x2E, 0xC8); // ucomisd xmm1, xmm0
+    }
+    else {
+        emit(c, 0x66, 0x0F, 0x2E, 0xC1); // ucomisd xmm0, xmm1
+    }
+    emitBooleanFromFlags(c, setcc);
+}
+
+/** Booleans only differ in their lowest bit, so they can be combined without being unwrapped. */
+static void compileBooleanOperation(JITCompiler *c, Byte operation){
+    compileOperands(c);
+    emit(c, 0x48, operation, 0xC8); // or/and rax, rcx
+}
+
+/** Compiles an increment or decrement of the variable at the index in the next cell. */
+static void compileVariableStep(JITCompiler *c, Byte operation){
+    int32_t offset = variableOffset(jitConsumeInstruction(c).coin);
+    emit(c, 0x48, 0x8B, 0x83); // mov rax, [rbx + disp32]
+    emit32(c, offset);
+    emitUnwrapInteger(c);
+    emit(c, 0x48, 0xFF, operation); // inc/dec rax
+    emitSomethingInteger(c);
+    emit(c, 0x48, 0x89, 0x83); // mov [rbx + disp32], rax
+    emit32(c, offset);
+    emitNothingness(c);
+}
+
+/** Compiles a block, whose first cell must be the block’s end. */
+static void compileBlock(JITCompiler *c){
+    Instruction *end = jitConsumeInstruction(c).target;
+    if (end > c->end) {
+        c->failed = true;
+        return;
+    }
+    while (!c->failed && c->instruction < end) {
+        compileExpression(c);
+    }
+}
+
+static void compileIf(JITCompiler *c){
+    Instruction *ifEnd = jitConsumeInstruction(c).target;
+
+    size_t *endJumps = NULL;
+    size_t endJumpsCount = 0;
+
+    EmojicodeCoin marker = 0;
+    do {
+        if (marker == 0x1F353) { //Else
+            compileBlock(c);
+            break;
+        }
+
+        compileExpression(c);
+        size_t skip = emitJumpIfNotTrue(c);
+        compileBlock(c);
+
+        endJumps = realloc(endJumps, sizeof(size_t) * (endJumpsCount + 1));
+        if (!endJumps) {
+            error("Could not allocate memory for the JIT.");
+        }
+        endJumps[endJumpsCount++] = emitJumpForward(c);
+        patchJump(c, skip, c->length);
+
+        marker = c->instruction < ifEnd ? jitConsumeInstruction(c).coin : 0;
+    } while (!c->failed && (marker == 0x1F34B || marker == 0x1F353));
+
+    if (c->instruction != ifEnd) {
+        c->failed = true;
+    }
+
+    for (size_t i = 0; i < endJumpsCount; i++) {
+        patchJump(c, endJumps[i], c->length);
+    }
+    free(endJumps);
+
+    emitNothingness(c);
+}
+
+static void compileExpression(JITCompiler *c){
+    if (c->failed) {
+        return;
+    }
+
+    switch (opcodeForHandler(jitConsumeInstruction(c).handler)) {
+        case 0x11:
+            emitValue(c, EMOJICODE_TRUE.bits);
+            return;
+        case 0x12:
+            emitValue(c, EMOJICODE_FALSE.bits);
+            return;
+        case 0x13:
+            emitValue(c, (uint64_t)jitConsumeInstruction(c).integer);
+            emitSomethingInteger(c);
+            return;
+        case 0x15: {
+            double value = jitConsumeInstruction(c).doubl;
+            emitValue(c, somethingDouble(value).bits);
+            return;
+        }
+        case 0x16:
+            emitValue(c, somethingSymbol((EmojicodeChar)jitConsumeInstruction(c).coin).bits);
+            return;
+        case 0x17:
+            emitNothingness(c);
+            return;
+        case 0x18:
+            compileVariableStep(c, 0xC0); // inc rax
+            return;
+        case 0x19:
+            compileVariableStep(c, 0xC8); // dec rax
+            return;
+        case 0x1A:
+            emit(c, 0x48, 0x8B, 0x83); // mov rax, [rbx + disp32]
+            emit32(c, variableOffset(jitConsumeInstruction(c).coin));
+            return;
+        case 0x1B: {
+            EmojicodeCoin index = jitConsumeInstruction(c).coin;
+            compileExpression(c);
+            emit(c, 0x48, 0x89, 0x83); // mov [rbx + disp32], rax
+            emit32(c, variableOffset(index));
+            emitNothingness(c);
+            return;
+        }
+        case 0x20:
+            compilePrimitiveEquality(c);
+            return;
+        case 0x21:
+            compileIntegerOperands(c);
+            emit(c, 0x48, 0x29, 0xC8); // sub rax, rcx
+            emitSomethingInteger(c);
+            return;
+        case 0x22:
+            compileIntegerOperands(c);
+            emit(c, 0x48, 0x01, 0xC8); // add rax, rcx
+            emitSomethingInteger(c);
+            return;
+        case 0x23:
+            compileIntegerOperands(c);
+            emit(c, 0x48, 0x0F, 0xAF, 0xC1); // imul rax, rcx
+            emitSomethingInteger(c);
+            return;
+        case 0x24:
+            compileIntegerOperands(c);
+            emit(c, 0x48, 0x99); // cqo
+            emit(c, 0x48, 0xF7, 0xF9); // idiv rcx
+            emitSomethingInteger(c);
+            return;
+        case 0x25:
+            compileIntegerOperands(c);
+            emit(c, 0x48, 0x99); // cqo
+            emit(c, 0x48, 0xF7, 0xF9); // idiv rcx
+            emit(c, 0x48, 0x89, 0xD0); // mov rax, rdx
+            emitSomethingInteger(c);
+            return;
+        case 0x26:
+            compileExpression(c);
+            emit(c, 0x48, 0x83, 0xF0, 0x01); // xor rax, 1
+            return;
+        case 0x27:
+            compileBooleanOperation(c, 0x09); // or
+            return;
+        case 0x28:
+            compileBooleanOperation(c, 0x21); // and
+            return;
+        case 0x29:
+            compileIntegerComparison(c, 0x9C); // setl
+            return;
+        case 0x2A:
+            compileIntegerComparison(c, 0x9F); // setg
+            return;
+        case 0x2B:
+            compileIntegerComparison(c, 0x9E); // setle
+            return;
+        case 0x2C:
+            compileIntegerComparison(c, 0x9D); // setge
+            return;
+        case 0x2D:
+            compileOperands(c);
+            emit(c, 0x48, 0x39, 0xC8); // cmp rax, rcx
+            emitBooleanFromFlags(c, 0x94); // sete
+            return;
+        case 0x2E:
+            compileExpression(c);
+            emit(c, 0x48, 0x85, 0xC0); // test rax, rax
+            emitBooleanFromFlags(c, 0x94); // sete
+            return;
+        case 0x2F:
+            compileDoubleOperands(c);
+            emit(c, 0x66, 0x0F, 0x2E, 0xC1); // ucomisd xmm0, xmm1
+            emit(c, 0x0F, 0x94, 0xC0); // sete al
+            emit(c, 0x0F, 0x9B, 0xC1); // setnp cl
+            emit(c, 0x20, 0xC8); // and al, cl
+            emit(c, 0x0F, 0xB6, 0xC0); // movzx eax, al
+            emit(c, 0x48, 0xB9); // mov rcx, imm64
+            emit64(c, SOMETHING_BOOLEAN_TAG);
+            emit(c, 0x48, 0x09, 0xC8); // or rax, rcx
+            return;
+        case 0x30:
+            compileDoubleOperation(c, 0x5C); // subsd
+            return;
+        case 0x31:
+            compileDoubleOperation(c, 0x58); // addsd
+            return;
+        case 0x32:
+            compileDoubleOperation(c, 0x59); // mulsd
+            return;
+        case 0x33:
+            compileDoubleOperation(c, 0x5E); // divsd
+            return;
+        case 0x34:
+            compileDoubleComparison(c, true, 0x97); // seta
+            return;
+        case 0x35:
+            compileDoubleComparison(c, false, 0x97); // seta
+            return;
+        case 0x36:
+            compileDoubleComparison(c, true, 0x93); // setae
+            return;
+        case 0x37:
+            compileDoubleComparison(c, false, 0x93); // setae
+            return;
+        case 0x60:
+            compileExpression(c);
+            if (c->depth != 0) {
+                c->failed = true;
+            }
+            emitReturn(c);
+            return;
+        case 0x61: {
+            jitConsumeInstruction(c); //The hotness counter, which is only needed by the interpreter
+            size_t begin = c->length;
+            compileExpression(c);
+            size_t exit = emitJumpIfNotTrue(c);
+            compileBlock(c);
+            //All values live across iterations are in variables, which makes this a safe point for the GC
+            emit(c, 0x48, 0xB8); // mov rax, imm64
+            emit64(c, (uint64_t)(uintptr_t)&safepointRequested);
+            emit(c, 0x80, 0x38, 0x00); // cmp byte [rax], 0
+            size_t skip = emitJump(c, (Byte[]){ 0x0F, 0x84 }, 2); // je
+            emitCall(c, (void *)jitSafepoint);
+            patchJump(c, skip, c->length);
+            emitJumpBackward(c, begin);
+            patchJump(c, exit, c->length);
+            emitNothingness(c);
+            return;
+        }
+        case 0x62:
+            compileIf(c);
+            return;
+        default:
+            c->failed = true;
+            return;
+    }
+}
+
+/** Compiles the given instructions. Returns @c NULL if they contain an instruction the JIT does not support. */
+static JITFunction jitCompile(Instruction *instructions, uint32_t instructionCount){
+    JITCompiler c = { instructions, instructions + instructionCount, NULL, 0, 0, 0, false };
+
+    emit(&c, 0x53); // push rbx
+    emit(&c, 0x48, 0x89, 0xFB); // mov rbx, rdi
+    while (!c.failed && c.instruction < c.end) {
+        compileExpression(&c);
+    }
+    emitNothingness(&c);
+    emitReturn(&c);
+
+    if (c.failed) {
+        free(c.code);
+        return NULL;
+    }
+
+    void *memory = mmap(NULL, c.length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        free(c.code);
+        return NULL;
+    }
+    memcpy(memory, c.code, c.length);
+    free(c.code);
+
+    if (mprotect(memory, c.length, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, c.length);
+        return NULL;
+    }
+
+    JITFunction function;
+    memcpy(&function, &memory, sizeof(function));
+    return function;
+}
+
+void jitConfigure(){
+    char *enabled = getenv("EMOJICODE_JIT");
+    jitEnabled = enabled && strcmp(enabled, "0") != 0;
+
+    char *threshold = getenv("EMOJICODE_JIT_THRESHOLD");
+    if (threshold) {
+        jitThreshold = (uint32_t)strtoul(threshold, NULL, 10);
+    }
+}
+
+bool jitTierUp(JITState *jit, Instruction *instructions, uint32_t instructionCount){
+    if (jit->attempted || ++jit->hotness < jitThreshold) {
+        return false;
+    }
+    
+    //Another thread might have reached the threshold at the same time
+    static pthread_mutex_t compilationMutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&compilationMutex);
+    if (!jit->attempted) {
+        jit->code = jitCompile(instructions, instructionCount);
+        jit->attempted = true;
+    }
+    pthread_mutex_unlock(&compilationMutex);
+    return jit->code != NULL;
+}
+
+#else
+
+void jitConfigure(){
+    //The JIT is only available on x86-64
+}
+
+bool jitTierUp(JITState *jit, Instruction *instructions, uint32_t instructionCount){
+    return false;
+}
+
+#endif
@@ -49,7 +49,7 @@ static Something JSONGetValue(const size_t length, size_t *i, Thread *thread){
     int numberDigits = 0;
     
     while (*i < length) {
-        c = characters((String *)stackGetThis(thread)->value)[(*i)++];
+        c = stringCharacterAt(objectValue(stackGetThis(thread)), (*i)++);
         
         switch (state) {
             case JSON_STRING:
@@ -59,7 +59,7 @@ static Something JSONGetValue(const size_t length, size_t *i, Thread *thread){
                         continue;
                     case '"': {
                         stackSetVariable(1, somethingObject(newObject(CL_STRING)), thread);
-                        initStringFromSymbolList(stackGetVariable(1, thread).object, stackGetVariable(0, thread).object->value);
+                        initStringFromSymbolList(stackGetVariable(1, thread).object, stackGetVariable(0, thread).object, thread);
                         Something s = stackGetVariable(1, thread);
                         stackPop(thread);
                         return s;
@@ -150,7 +150,7 @@ static Something JSONGetValue(const size_t length, size_t *i, Thread *thread){
             case JSON_OBJECT_KEY: {
                 (*i)--;
                 Something s = JSONGetValue(length, i, thread);
-                if (s.type != T_OBJECT || s.object->class != CL_STRING) {
+                if (!isRealObject(s) || s.object->class != CL_STRING) {
                     jsonError();
                 }
                 stackSetVariable(1, s, thread);
@@ -170,7 +170,7 @@ static Something JSONGetValue(const size_t length, size_t *i, Thread *thread){
             case JSON_OBJECT_VALUE: {
                 (*i)--;
                 Something s = JSONGetValue(length, i, thread);
-                dictionarySet(stackGetVariable(0, thread).object, stackGetVariable(1, thread).object, s, thread);
+                dictionarySet(stackGetVariable(0, thread).object, stackGetVariable(1, thread), s, thread);
                 state = JSON_OBJECT_NEXT;
                 continue;
             }
@@ -267,5 +267,5 @@ static Something JSONGetValue(const size_t length, size_t *i, Thread *thread){
 
 Something parseJSON(Thread *thread){
     size_t i = 0;
-    return JSONGetValue(((String*)stackGetThis(thread)->value)->length, &i, thread);
+    return JSONGetValue(((String*)objectValue(stackGetThis(thread)))->length, &i, thread);
 }
\ No newline at end of file
@@ -0,0 +1,391 @@
+//
+//  ListSort.h
+//  Emojicode
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+/*
+ * This file generates sorting functions and is meant to be included once per element type. Define these macros
+ * before including it:
+ *
+ * - SORT_NAME(name): Prefixes the name of a generated function, e.g. `#define SORT_NAME(name) integer ## name`.
+ * - SORT_CONTEXT: The type of the context that is passed to SORT_LESS and SORT_SWAP.
+ * - SORT_LESS(context, a, b): Whether the element at index a must be ordered before the element at index b.
+ * - SORT_SWAP(context, a, b): Swaps the elements at index a and b.
+ * - SORT_STABLE: Optional. Also generate a stable sort.
+ * - SORT_GUARDED: Optional. Bound the partitioning by the range. Without it the partitioning relies on SORT_LESS being
+ *   a strict weak order to stop, which is not guaranteed for user code or doubles that are NaN.
+ *
+ * The elements are only accessed through their indices and no element is ever held outside the sorted storage, which
+ * allows SORT_LESS to run code that moves the storage, e.g. an Emojicode closure that invokes the Garbage Collector.
+ *
+ * The generated SORT_NAME(Sort) is a pattern-defeating quicksort, which falls back to heap sort if it encounters too
+ * many bad partitions. SORT_NAME(StableSort) sorts blocks with insertion sort and merges them in place with SymMerge.
+ */
+
+#ifndef SORT_NAME
+#error SORT_NAME must be defined before including ListSort.h
+#endif
+
+#ifndef ListSort_h
+#define ListSort_h
+
+/** Ranges smaller than this are sorted with insertion sort. */
+#define SORT_INSERTION_THRESHOLD 24
+/** Ranges larger than this use the pseudomedian of nine as pivot. */
+#define SORT_NINTHER_THRESHOLD 128
+/** The number of elements a partial insertion sort may move before it gives up. */
+#define SORT_PARTIAL_INSERTION_LIMIT 8
+/** The size of the blocks the stable sort sorts with insertion sort before it starts merging. */
+#define SORT_STABLE_BLOCK_SIZE 20
+
+#endif /* ListSort_h */
+
+#ifdef SORT_GUARDED
+#define SORT_NEXT(i, end) (++(i) < (end))
+#define SORT_PREVIOUS(i, begin) (--(i) > (begin))
+#else
+#define SORT_NEXT(i, end) (++(i), true)
+#define SORT_PREVIOUS(i, begin) (--(i), true)
+#endif
+
+static void SORT_NAME(InsertionSort)(SORT_CONTEXT c, size_t begin, size_t end){
+    for (size_t i = begin + 1; i < end; i++) {
+        for (size_t j = i; j > begin && SORT_LESS(c, j, j - 1); j--) {
+            SORT_SWAP(c, j, j - 1);
+        }
+    }
+}
+
+/** Insertion sort that gives up if it has to move too many elements. Returns whether the range is sorted. */
+static bool SORT_NAME(PartialInsertionSort)(SORT_CONTEXT c, size_t begin, size_t end){
+    size_t moves = 0;
+    for (size_t i = begin + 1; i < end; i++) {
+        for (size_t j = i; j > begin && SORT_LESS(c, j, j - 1); j--) {
+            SORT_SWAP(c, j, j - 1);
+            moves++;
+        }
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void SORT_NAME(Sort2)(SORT_CONTEXT c, size_t a, size_t b){
+    if (SORT_LESS(c, b, a)) {
+        SORT_SWAP(c, a, b);
+    }
+}
+
+static void SORT_NAME(Sort3)(SORT_CONTEXT c, size_t a, size_t b, size_t d){
+    SORT_NAME(Sort2)(c, a, b);
+    SORT_NAME(Sort2)(c, b, d);
+    SORT_NAME(Sort2)(c, a, b);
+}
+
+static void SORT_NAME(SiftDown)(SORT_CONTEXT c, size_t begin, size_t root, size_t count){
+    while (true) {
+        size_t child = 2 * root + 1;
+        if (child >= count) {
+            return;
+        }
+        if (child + 1 < count && SORT_LESS(c, begin + child, begin + child + 1)) {
+            child++;
+        }
+        if (!SORT_LESS(c, begin + root, begin + child)) {
+            return;
+        }
+        SORT_SWAP(c, begin + root, begin + child);
+        root = child;
+    }
+}
+
+static void SORT_NAME(HeapSort)(SORT_CONTEXT c, size_t begin, size_t end){
+    size_t count = end - begin;
+    for (size_t i = count / 2; i-- > 0;) {
+        SORT_NAME(SiftDown)(c, begin, i, count);
+    }
+    for (size_t i = count; i-- > 1;) {
+        SORT_SWAP(c, begin, begin + i);
+        SORT_NAME(SiftDown)(c, begin, 0, i);
+    }
+}
+
+/**
+ * Partitions [begin, end) around the pivot at @c begin. Elements equal to the pivot go to the right partition.
+ * Returns the final position of the pivot and whether the range was already partitioned.
+ */
+static size_t SORT_NAME(PartitionRight)(SORT_CONTEXT c, size_t begin, size_t end, bool *alreadyPartitioned){
+    size_t first = begin;
+    size_t last = end;
+
+    //The median of three guarantees that there is an element that is not less than the pivot
+    while (SORT_NEXT(first, end) && SORT_LESS(c, first, begin));
+
+    if (first - 1 == begin) {
+        while (first < last && !SORT_LESS(c, --last, begin));
+    }
+    else {
+        while (SORT_PREVIOUS(last, begin) && !SORT_LESS(c, last, begin));
+    }
+
+    *alreadyPartitioned = first >= last;
+
+    while (first < last) {
+        SORT_SWAP(c, first, last);
+        while (SORT_NEXT(first, end) && SORT_LESS(c, first, begin));
+        while (SORT_PREVIOUS(last, begin) && !SORT_LESS(c, last, begin));
+    }
+
+    size_t pivotPosition = first - 1;
+    SORT_SWAP(c, begin, pivotPosition);
+    return pivotPosition;
+}
+
+/**
+ * Partitions [begin, end) around the pivot at @c begin. Elements equal to the pivot go to the left partition. This is
+ * used if the pivot is equal to the pivot of the previous partitioning, all elements equal to it are then in place.
+ */
+static size_t SORT_NAME(PartitionLeft)(SORT_CONTEXT c, size_t begin, size_t end){
+    size_t first = begin;
+    size_t last = end;
+
+    while (SORT_PREVIOUS(last, begin) && SORT_LESS(c, begin, last));
+
+    if (last + 1 == end) {
+        while (first < last && !SORT_LESS(c, begin, ++first));
+    }
+    else {
+        while (SORT_NEXT(first, end) && !SORT_LESS(c, begin, first));
+    }
+
+    while (first < last) {
+        SORT_SWAP(c, first, last);
+        while (SORT_PREVIOUS(last, begin) && SORT_LESS(c, begin, last));
+        while (SORT_NEXT(first, end) && !SORT_LESS(c, begin, first));
+    }
+
+    SORT_SWAP(c, begin, last);
+    return last;
+}
+
+static void SORT_NAME(SortLoop)(SORT_CONTEXT c, size_t begin, size_t end, int badAllowed, bool leftmost){
+    while (true) {
+        size_t size = end - begin;
+
+        if (size < SORT_INSERTION_THRESHOLD) {
+            SORT_NAME(InsertionSort)(c, begin, end);
+            return;
+        }
+
+        //Move the pivot to begin
+        size_t half = size / 2;
+        if (size > SORT_NINTHER_THRESHOLD) {
+            SORT_NAME(Sort3)(c, begin, begin + half, end - 1);
+            SORT_NAME(Sort3)(c, begin + 1, begin + (half - 1), end - 2);
+            SORT_NAME(Sort3)(c, begin + 2, begin + (half + 1), end - 3);
+            SORT_NAME(Sort3)(c, begin + (half - 1), begin + half, begin + (half + 1));
+            SORT_SWAP(c, begin, begin + half);
+        }
+        else {
+            SORT_NAME(Sort3)(c, begin + half, begin, end - 1);
+        }
+
+        //The element before begin is the pivot of a previous partitioning and not greater than any element in the
+        //range. If it is equal to the new pivot, all elements equal to it can be put in place at once.
+        if (!leftmost && !SORT_LESS(c, begin - 1, begin)) {
+            begin = SORT_NAME(PartitionLeft)(c, begin, end) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned;
+        size_t pivotPosition = SORT_NAME(PartitionRight)(c, begin, end, &alreadyPartitioned);
+
+        size_t leftSize = pivotPosition - begin;
+        size_t rightSize = end - (pivotPosition + 1);
+
+        if (leftSize < size / 8 || rightSize < size / 8) {
+            if (--badAllowed == 0) {
+                SORT_NAME(HeapSort)(c, begin, end);
+                return;
+            }
+
+            //Break patterns that might have caused the bad partition
+            if (leftSize >= SORT_INSERTION_THRESHOLD) {
+                SORT_SWAP(c, begin, begin + leftSize / 4);
+                SORT_SWAP(c, pivotPosition - 1, pivotPosition - leftSize / 4);
+                if (leftSize > SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(c, begin + 1, begin + (leftSize / 4 + 1));
+                    SORT_SWAP(c, begin + 2, begin + (leftSize / 4 + 2));
+                    SORT_SWAP(c, pivotPosition - 2, pivotPosition - (leftSize / 4 + 1));
+                    SORT_SWAP(c, pivotPosition - 3, pivotPosition - (leftSize / 4 + 2));
+                }
+            }
+            if (rightSize >= SORT_INSERTION_THRESHOLD) {
+                SORT_SWAP(c, pivotPosition + 1, pivotPosition + (1 + rightSize / 4));
+                SORT_SWAP(c, end - 1, end - rightSize / 4);
+                if (rightSize > SORT_NINTHER_THRESHOLD) {
+                    SORT_SWAP(c, pivotPosition + 2, pivotPosition + (2 + rightSize / 4));
+                    SORT_SWAP(c, pivotPosition + 3, pivotPosition + (3 + rightSize / 4));
+                    SORT_SWAP(c, end - 2, end - (1 + rightSize / 4));
+                    SORT_SWAP(c, end - 3, end - (2 + rightSize / 4));
+                }
+            }
+        }
+        else if (alreadyPartitioned && SORT_NAME(PartialInsertionSort)(c, begin, pivotPosition)
+                 && SORT_NAME(PartialInsertionSort)(c, pivotPosition + 1, end)) {
+            return;
+        }
+
+        //Recurse into the smaller partition to bound the recursion depth
+        if (leftSize < rightSize) {
+            SORT_NAME(SortLoop)(c, begin, pivotPosition, badAllowed, leftmost);
+            begin = pivotPosition + 1;
+            leftmost = false;
+        }
+        else {
+            SORT_NAME(SortLoop)(c, pivotPosition + 1, end, badAllowed, false);
+            end = pivotPosition;
+        }
+    }
+}
+
+/** Sorts the @c count elements. Not stable. */
+static void SORT_NAME(Sort)(SORT_CONTEXT c, size_t count){
+    int badAllowed = 1;
+    for (size_t n = count; n > 1; n >>= 1) {
+        badAllowed++;
+    }
+    SORT_NAME(SortLoop)(c, 0, count, badAllowed, true);
+}
+
+#ifdef SORT_STABLE
+
+/** Swaps the @c count elements starting at @c a with those starting at @c b. */
+static void SORT_NAME(SwapRange)(SORT_CONTEXT c, size_t a, size_t b, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        SORT_SWAP(c, a + i, b + i);
+    }
+}
+
+/** Rotates [a, b) so that the element at @c m becomes the first one. */
+static void SORT_NAME(Rotate)(SORT_CONTEXT c, size_t a, size_t m, size_t b){
+    size_t i = m - a;
+    size_t j = b - m;
+    while (i != j) {
+        if (i > j) {
+            SORT_NAME(SwapRange)(c, m - i, m, j);
+            i -= j;
+        }
+        else {
+            SORT_NAME(SwapRange)(c, m - i, m + j - i, i);
+            j -= i;
+        }
+    }
+    SORT_NAME(SwapRange)(c, m - i, m, i);
+}
+
+/** Merges the sorted ranges [a, m) and [m, b) in place. (Kim and Kutzner, "Stable Minimum Storage Merging") */
+static void SORT_NAME(SymMerge)(SORT_CONTEXT c, size_t a, size_t m, size_t b){
+    if (m - a == 1) {
+        //Insert the single element of the left range by binary search
+        size_t i = m;
+        size_t j = b;
+        while (i < j) {
+            size_t h = i + (j - i) / 2;
+            if (SORT_LESS(c, h, a)) {
+                i = h + 1;
+            }
+            else {
+                j = h;
+            }
+        }
+        for (size_t k = a; k + 1 < i; k++) {
+            SORT_SWAP(c, k, k + 1);
+        }
+        return;
+    }
+    if (b - m == 1) {
+        size_t i = a;
+        size_t j = m;
+        while (i < j) {
+            size_t h = i + (j - i) / 2;
+            if (!SORT_LESS(c, m, h)) {
+                i = h + 1;
+            }
+            else {
+                j = h;
+            }
+        }
+        for (size_t k = m; k > i; k--) {
+            SORT_SWAP(c, k, k - 1);
+        }
+        return;
+    }
+
+    size_t mid = a + (b - a) / 2;
+    size_t n = mid + m;
+    size_t start, r;
+    if (m > mid) {
+        start = n - b;
+        r = mid;
+    }
+    else {
+        start = a;
+        r = m;
+    }
+    size_t p = n - 1;
+    while (start < r) {
+        size_t h = start + (r - start) / 2;
+        if (!SORT_LESS(c, p - h, h)) {
+            start = h + 1;
+        }
+        else {
+            r = h;
+        }
+    }
+
+    size_t end = n - start;
+    if (start < m && m < end) {
+        SORT_NAME(Rotate)(c, start, m, end);
+    }
+    if (a < start && start < mid) {
+        SORT_NAME(SymMerge)(c, a, start, mid);
+    }
+    if (mid < end && end < b) {
+        SORT_NAME(SymMerge)(c, mid, end, b);
+    }
+}
+
+/** Sorts the @c count elements. Equal elements keep their order. */
+static void SORT_NAME(StableSort)(SORT_CONTEXT c, size_t count){
+    size_t a = 0;
+    for (; a + SORT_STABLE_BLOCK_SIZE <= count; a += SORT_STABLE_BLOCK_SIZE) {
+        SORT_NAME(InsertionSort)(c, a, a + SORT_STABLE_BLOCK_SIZE);
+    }
+    SORT_NAME(InsertionSort)(c, a, count);
+
+    for (size_t blockSize = SORT_STABLE_BLOCK_SIZE; blockSize < count; blockSize *= 2) {
+        a = 0;
+        for (; a + 2 * blockSize <= count; a += 2 * blockSize) {
+            SORT_NAME(SymMerge)(c, a, a + blockSize, a + 2 * blockSize);
+        }
+        if (a + blockSize < count) {
+            SORT_NAME(SymMerge)(c, a, a + blockSize, count);
+        }
+    }
+}
+
+#endif /* SORT_STABLE */
+
+#undef SORT_NAME
+#undef SORT_CONTEXT
+#undef SORT_LESS
+#undef SORT_SWAP
+#undef SORT_STABLE
+#undef SORT_GUARDED
+#undef SORT_NEXT
+#undef SORT_PREVIOUS
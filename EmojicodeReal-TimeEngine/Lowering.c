@@ -0,0 +1,369 @@
+//
+//  Lowering.c
+//  Emojicode
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "Emojicode.h"
+#include <math.h>
+
+typedef struct {
+    EmojicodeCoin *coins;
+    uint32_t coinCount;
+    Instruction **instructions;
+    uint32_t *instructionCount;
+    uint32_t *hotness;
+} ScheduledBlock;
+
+/** Incremented by loops of procedures whose hotness is not tracked. */
+static uint32_t untrackedHotness;
+
+static ScheduledBlock *scheduledBlocks = NULL;
+static size_t scheduledBlocksCount = 0;
+static size_t scheduledBlocksCapacity = 0;
+
+/**
+ * The state of the lowering of a single coin stream. The stream is lowered twice: The first pass only counts the
+ * instruction cells needed (@c instructions is @c NULL), the second one writes them.
+ */
+typedef struct {
+    EmojicodeCoin *coin;
+    EmojicodeCoin *end;
+    Instruction *instructions;
+    size_t position;
+    uint32_t *hotness;
+    /** Whether an instruction lowered so far might allocate objects, call code or modify objects. */
+    bool allocates;
+} Lowerer;
+
+static EmojicodeCoin lowererConsumeCoin(Lowerer *l){
+    if (l->coin >= l->end) {
+        error("Malformed bytecode: Unexpected end of coin stream.");
+    }
+    return *(l->coin++);
+}
+
+static size_t emit(Lowerer *l, Instruction instruction){
+    if (l->instructions) {
+        l->instructions[l->position] = instruction;
+    }
+    return l->position++;
+}
+
+#define emitHandler(l, opcode) emit(l, (Instruction){ .handler = instructionHandler(opcode) })
+#define emitCoin(l) emit(l, (Instruction){ .coin = lowererConsumeCoin(l) })
+
+/** Emits a cell whose target is set by @c patchTarget. */
+static size_t emitTarget(Lowerer *l){
+    return emit(l, (Instruction){ .target = NULL });
+}
+
+/** Makes the target cell at @c cell point to the next instruction cell. */
+static void patchTarget(Lowerer *l, size_t cell){
+    if (l->instructions) {
+        l->instructions[cell].target = l->instructions + l->position;
+    }
+}
+
+/** Emits a cell with a new, empty inline cache. */
+static void emitCache(Lowerer *l){
+    InlineCache *cache = NULL;
+    if (l->instructions) {
+        cache = calloc(1, sizeof(InlineCache));
+        if (!cache) {
+            error("Could not allocate memory for inline cache.");
+        }
+    }
+    emit(l, (Instruction){ .cache = cache });
+}
+
+static void emitClass(Lowerer *l){
+    EmojicodeCoin classIndex = lowererConsumeCoin(l);
+    emit(l, (Instruction){ .class = classIndex == UINT32_MAX ? NULL : classTable[classIndex] });
+}
+
+static void lowerExpression(Lowerer *l);
+
+/**
+ * Returns whether the instruction @c opcode is known to neither allocate objects, nor to call methods, initializers
+ * or callables, nor to modify objects. Integer boxes, which might be created by any arithmetic, are not considered.
+ */
+static bool isAllocationFree(EmojicodeCoin opcode){
+    switch (opcode) {
+        case 0x10: case 0x11: case 0x12: case 0x13: case 0x15: case 0x16: case 0x17:
+        case 0x18: case 0x19: case 0x1A: case 0x1B: case 0x1C:
+        case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+        case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D: case 0x2E: case 0x2F:
+        case 0x30: case 0x31: case 0x32: case 0x33: case 0x34: case 0x35: case 0x36: case 0x37:
+        case 0x3A: case 0x3C: case 0x3E:
+        case 0x40: case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x46: case 0x47:
+        case 0x60: case 0x61: case 0x62: case 0x65: case 0x67:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** Lowers coins until @c end is reached. */
+static void lowerSequence(Lowerer *l, EmojicodeCoin *end){
+    if (end > l->end) {
+        error("Malformed bytecode: Block exceeds the procedure.");
+    }
+    while (l->coin < end) {
+        lowerExpression(l);
+    }
+}
+
+/** Reads a coin count and returns a pointer to the coin after the counted coins. */
+static EmojicodeCoin* lowerCount(Lowerer *l){
+    EmojicodeCoin count = lowererConsumeCoin(l);
+    return l->coin + count;
+}
+
+/** Lowers a block and replaces its length with the absolute position of the block’s end. */
+static void lowerBlock(Lowerer *l){
+    size_t target = emitTarget(l);
+    lowerSequence(l, lowerCount(l));
+    patchTarget(l, target);
+}
+
+/**
+ * Lowers the arguments of a call. The compiler writes the number of arguments in front of them, as their count
+ * otherwise depended on the method resolved at run-time. The count itself is not needed by the interpreter.
+ */
+static void lowerArguments(Lowerer *l){
+    EmojicodeCoin argumentCount = lowererConsumeCoin(l);
+    for (EmojicodeCoin i = 0; i < argumentCount; i++) {
+        lowerExpression(l);
+    }
+}
+
+static void lowerExpression(Lowerer *l){
+    EmojicodeCoin opcode = lowererConsumeCoin(l);
+
+    if (opcode == 0x14) { //64-bit integers are lowered to the ordinary integer literal
+        EmojicodeInteger high = lowererConsumeCoin(l);
+        EmojicodeInteger low = lowererConsumeCoin(l);
+        emitHandler(l, 0x13);
+        emit(l, (Instruction){ .integer = high << 32 | low });
+        return;
+    }
+
+    emitHandler(l, opcode);
+
+    if (!isAllocationFree(opcode)) {
+        l->allocates = true;
+    }
+
+    switch (opcode) {
+        case 0x1:
+            lowerExpression(l);
+            emitCoin(l);
+            emitCache(l);
+            lowerArguments(l);
+            return;
+        case 0x71:
+            lowerExpression(l);
+            emitCoin(l);
+            emitCache(l);
+            return;
+        case 0x2:
+        case 0x4:
+        case 0x5:
+        case 0x3D:
+            emitClass(l);
+            emitCoin(l);
+            lowerArguments(l);
+            return;
+        case 0x3:
+            lowerExpression(l);
+            emitCoin(l);
+            emitCoin(l);
+            emitCache(l);
+            lowerArguments(l);
+            return;
+        case 0x10: {
+            EmojicodeCoin index = lowererConsumeCoin(l);
+            if (index >= stringPoolCount) {
+                error("Malformed bytecode: String pool index %d out of range.", index);
+            }
+            emit(l, (Instruction){ .string = stringPool + index });
+            return;
+        }
+        case 0x13:
+            emit(l, (Instruction){ .integer = (EmojicodeInteger)(int)lowererConsumeCoin(l) });
+            return;
+        case 0x15: {
+            EmojicodeInteger scale = ((EmojicodeInteger)lowererConsumeCoin(l) << 32) ^ lowererConsumeCoin(l);
+            EmojicodeInteger exp = lowererConsumeCoin(l);
+            emit(l, (Instruction){ .doubl = ldexp((double)scale/PORTABLE_INTLEAST64_MAX, (int)exp) });
+            return;
+        }
+        case 0x16:
+        case 0x18:
+        case 0x19:
+        case 0x1A:
+        case 0x1C:
+        case 0x1E:
+        case 0x1F:
+            emitCoin(l);
+            return;
+        case 0x1B:
+        case 0x1D:
+        case 0x3E:
+            emitCoin(l);
+            lowerExpression(l);
+            return;
+        case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25:
+        case 0x27: case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D:
+        case 0x2F: case 0x30: case 0x31: case 0x32: case 0x33: case 0x34: case 0x35: case 0x36: case 0x37:
+            lowerExpression(l);
+            lowerExpression(l);
+            return;
+        case 0x26:
+        case 0x2E:
+        case 0x3A:
+        case 0x42:
+        case 0x43:
+        case 0x46:
+        case 0x47:
+        case 0x60:
+            lowerExpression(l);
+            return;
+        case 0x72:
+            lowerExpression(l);
+            lowerArguments(l);
+            return;
+        case 0x3B: {
+            //The count covers the callee, the vti and the arguments
+            size_t target = emitTarget(l);
+            EmojicodeCoin *end = lowerCount(l);
+            lowerExpression(l);
+            emitCoin(l);
+            emitCache(l);
+            lowerArguments(l);
+            if (l->coin != end) {
+                error("Malformed bytecode: 🍻 length does not match its call.");
+            }
+            patchTarget(l, target);
+            return;
+        }
+        case 0x40:
+        case 0x44:
+            lowerExpression(l);
+            emitClass(l);
+            return;
+        case 0x41:
+        case 0x45:
+            lowerExpression(l);
+            emitCoin(l);
+            return;
+        case 0x50:
+            lowerBlock(l);
+            return;
+        case 0x51:
+            emitCoin(l); //The storage of the list
+            lowerBlock(l);
+            return;
+        case 0x52: {
+            EmojicodeCoin stringCount = lowererConsumeCoin(l);
+            emit(l, (Instruction){ .coin = stringCount });
+            for (EmojicodeCoin i = 0; i < stringCount; i++) {
+                lowerExpression(l);
+            }
+            return;
+        }
+        case 0x61:
+            emit(l, (Instruction){ .counter = l->hotness });
+            lowerExpression(l);
+            lowerBlock(l);
+            return;
+        case 0x67:
+            lowerExpression(l);
+            lowerBlock(l);
+            return;
+        case 0x62: {
+            size_t ifEndTarget = emitTarget(l);
+            EmojicodeCoin *ifEnd = lowerCount(l);
+
+            lowerExpression(l);
+            lowerBlock(l);
+
+            while (l->coin < ifEnd && *l->coin == 0x1F34B) { //All else ifs
+                emitCoin(l);
+                lowerExpression(l);
+                lowerBlock(l);
+            }
+            if (l->coin < ifEnd && *l->coin == 0x1F353) { //Else
+                emitCoin(l);
+                lowerBlock(l);
+            }
+            lowerSequence(l, ifEnd);
+            patchTarget(l, ifEndTarget);
+            return;
+        }
+        case 0x64:
+        case 0x65:
+            emitCoin(l);
+            emitCoin(l);
+            lowerExpression(l);
+            lowerBlock(l);
+            return;
+        case 0x70: {
+            emitCoin(l); //The number of variables
+
+            //Creating the closure allocates, but its body is analyzed on its own
+            bool allocates = l->allocates;
+            l->allocates = false;
+            lowerBlock(l); //The closure’s body
+            bool closureAllocates = l->allocates;
+            l->allocates = allocates;
+
+            emitCoin(l); //The number of arguments
+            emitCoin(l); //The number of captured variables
+            emit(l, (Instruction){ .coin = !closureAllocates }); //Whether the closure is allocation-free
+            return;
+        }
+    }
+}
+
+static Instruction* lowerCoins(EmojicodeCoin *coins, uint32_t coinCount, uint32_t *instructionCount, uint32_t *hotness){
+    Lowerer counter = { coins, coins + coinCount, NULL, 0, hotness, false };
+    lowerSequence(&counter, counter.end);
+
+    Instruction *instructions = malloc(sizeof(Instruction) * (counter.position ? counter.position : 1));
+    if (!instructions) {
+        error("Could not allocate memory for instructions.");
+    }
+
+    Lowerer lowerer = { coins, coins + coinCount, instructions, 0, hotness, false };
+    lowerSequence(&lowerer, lowerer.end);
+
+    *instructionCount = (uint32_t)lowerer.position;
+    return instructions;
+}
+
+void scheduleLowering(EmojicodeCoin *coins, uint32_t coinCount, Instruction **instructions, uint32_t *instructionCount, uint32_t *hotness){
+    if (scheduledBlocksCount == scheduledBlocksCapacity) {
+        scheduledBlocksCapacity = scheduledBlocksCapacity ? scheduledBlocksCapacity * 2 : 64;
+        scheduledBlocks = realloc(scheduledBlocks, sizeof(ScheduledBlock) * scheduledBlocksCapacity);
+        if (!scheduledBlocks) {
+            error("Could not allocate memory for lowering.");
+        }
+    }
+    scheduledBlocks[scheduledBlocksCount++] = (ScheduledBlock){ coins, coinCount, instructions, instructionCount, hotness ? hotness : &untrackedHotness };
+}
+
+void lowerScheduledBlocks(){
+    for (size_t i = 0; i < scheduledBlocksCount; i++) {
+        ScheduledBlock *block = scheduledBlocks + i;
+        *block->instructions = lowerCoins(block->coins, block->coinCount, block->instructionCount, block->hotness);
+        free(block->coins);
+    }
+
+    free(scheduledBlocks);
+    scheduledBlocks = NULL;
+    scheduledBlocksCount = scheduledBlocksCapacity = 0;
+}
@@ -9,61 +9,516 @@
 #include "EmojicodeAPI.h"
 #include "Emojicode.h"
 #include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <inttypes.h>
+#include <pthread.h>
 
+/*
+ * The heap is split into a nursery and an old generation. New objects are bump-allocated in the nursery, which is
+ * collected frequently and cheaply: Everything that survives a nursery collection is promoted into the old generation
+ * at once. The old generation is a pair of semispaces that is only copied when a full collection is performed.
+ *
+ * References from the old generation into the nursery are tracked with a write barrier, see @c writeBarrier.
+ *
+ * The address space for the maximum heap size is reserved up front, but memory is only committed as the live data
+ * grows. After a full collection the evacuated semispace is given back to the operating system.
+ *
+ * Objects larger than @c largeObjectThreshold are never copied. They are allocated on their own pages in the large
+ * object space, which is reserved behind the semispaces and managed with mark and sweep during full collections.
+ *
+ * Every thread bump-allocates in its own part of the nursery, its thread-local allocation buffer, and only takes
+ * @c heapMutex to get a new buffer. All other shared structures of the heap are modified under @c heapMutex as well,
+ * except during collections, which are only performed after all other threads were stopped, see @c stopTheWorld.
+ */
+
+static pthread_mutex_t heapMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static Byte *nursery;
+static Byte *heapEnd;
+static size_t nurseryUse = 0;
 static size_t memoryUse = 0;
-static bool zeroingNeeded = true;
 
-static size_t gcThreshold = heapSize / 2;
+/** Whether the current collection only collects the nursery. */
+static bool collectingNursery = false;
 
-static void* emojicodeMalloc(size_t size){
-    if (memoryUse + size > gcThreshold) {
-        if (size > gcThreshold) {
-            error("Allocation of %ld bytes is too big. Try to enlarge the heap. (Heap size: %ld)", size, heapSize);
+GCStatistics gcStatistics;
+/** Whether a JSON line is written to @c stderr for every collection. */
+static bool gcEventLog = false;
+
+/** A growable list of objects that is kept outside of the heap. */
+typedef struct {
+    Object **objects;
+    size_t count;
+    size_t capacity;
+} ObjectRegistry;
+
+/** Old objects that might contain references into the nursery. */
+static ObjectRegistry rememberedSet;
+
+/** Objects whose class has a deinitializer, split by generation. */
+static ObjectRegistry youngFinalizables;
+static ObjectRegistry oldFinalizables;
+
+/** The size of a semispace at which a full collection is triggered. It is adjusted after every full collection. */
+static size_t oldGenerationLimit;
+/** The size of the address space reserved for each semispace. */
+static size_t oldGenerationMaximum;
+static size_t initialOldGenerationLimit;
+/** The factor by which the live data may grow until the next full collection. */
+static double heapGrowthFactor = 2;
+
+/** The number of bytes committed at the beginning of @c currentHeap and @c otherHeap. */
+static size_t currentHeapCommitted = 0;
+static size_t otherHeapCommitted = 0;
+
+/** Memory is committed in chunks of this size to keep the number of system calls low. */
+#define commitGranularity ((size_t)1 << 20)
+#define alignToGranularity(size) (((size) + commitGranularity - 1) & ~(commitGranularity - 1))
+
+/** The size of the thread-local allocation buffers. Larger blocks are taken from the nursery directly. */
+#define allocationBufferSize (nurserySize / 64 < 32 * 1024 ? nurserySize / 64 : 32 * 1024)
+
+/** Blocks larger than this are allocated in the large object space. */
+#define largeObjectThreshold (nurserySize / 4 < 256 * 1024 ? nurserySize / 4 : 256 * 1024)
+#define alignToPage(size) (((size) + pageSize - 1) & ~(pageSize - 1))
+static size_t pageSize;
+
+/** A free range of pages in the large object space. */
+typedef struct {
+    size_t offset;
+    size_t size;
+} LargeObjectExtent;
+
+static Byte *largeObjectSpace;
+/** All objects in the large object space. */
+static ObjectRegistry largeObjects;
+/** Large objects that were marked but whose references were not yet scanned. */
+static ObjectRegistry largeObjectsToScan;
+/** The free ranges below @c largeObjectSpaceTop, sorted by offset. */
+static LargeObjectExtent *largeObjectExtents;
+static size_t largeObjectExtentCount = 0;
+static size_t largeObjectExtentCapacity = 0;
+static size_t largeObjectSpaceTop = 0;
+static size_t largeObjectUse = 0;
+/** The amount of large objects at which a full collection is triggered. It is adjusted after every full collection. */
+static size_t largeObjectLimit;
+
+/** Object sizes are multiples of 8, so the lowest bits of the size are used to flag remembered and marked objects. */
+#define REMEMBERED_FLAG ((size_t)1)
+#define MARKED_FLAG ((size_t)2)
+#define objectSize(o) ((o)->size & ~(size_t)7)
+
+/** Evacuated objects are overwritten with a forwarding pointer, which is tagged with the lowest bit. */
+#define isForwarded(o) ((uintptr_t)(o)->class & 1)
+#define forwardingAddress(o) ((Object *)((uintptr_t)(o)->class & ~(uintptr_t)1))
+#define alignSize(size) (((size) + 7) & ~(size_t)7)
+
+static inline bool isInNursery(void *p){
+    return (Byte *)p >= nursery && (Byte *)p < nursery + nurserySize;
+}
+
+static inline bool isLargeObject(void *p){
+    return (Byte *)p >= largeObjectSpace && (Byte *)p < heapEnd;
+}
+
+static void collectNursery(Thread *thread);
+
+/** Makes sure that the first @c use bytes of the current semispace can be written. */
+static void commitOldGeneration(size_t use){
+    if (use <= currentHeapCommitted) {
+        return;
+    }
+    size_t committed = alignToGranularity(use);
+    if (committed > oldGenerationMaximum) {
+        committed = oldGenerationMaximum;
+    }
+    if (mprotect(currentHeap + currentHeapCommitted, committed - currentHeapCommitted, PROT_READ | PROT_WRITE) != 0) {
+        error("Cannot commit heap memory!");
+    }
+    currentHeapCommitted = committed;
+}
+
+/** Returns the memory of the evacuated semispace to the operating system. */
+static void decommitOtherHeap(){
+    if (otherHeapCommitted == 0) {
+        return;
+    }
+    madvise(otherHeap, otherHeapCommitted, MADV_DONTNEED);
+    mprotect(otherHeap, otherHeapCommitted, PROT_NONE);
+    otherHeapCommitted = 0;
+}
+
+static void registryAppend(ObjectRegistry *registry, Object *o){
+    if (registry->count == registry->capacity) {
+        registry->capacity = registry->capacity ? registry->capacity * 2 : 64;
+        registry->objects = realloc(registry->objects, registry->capacity * sizeof(Object *));
+        if (!registry->objects) {
+            error("Cannot allocate object registry!");
+        }
+    }
+    registry->objects[registry->count++] = o;
+}
+
+/** Takes @c size bytes of pages from the large object space and commits them. */
+static Byte* largeObjectSpaceAllocate(size_t size){
+    size_t offset = largeObjectSpaceTop;
+    
+    size_t i = 0;
+    while (i < largeObjectExtentCount && largeObjectExtents[i].size < size) {
+        i++;
+    }
+    if (i < largeObjectExtentCount) {
+        offset = largeObjectExtents[i].offset;
+        largeObjectExtents[i].offset += size;
+        largeObjectExtents[i].size -= size;
+        if (largeObjectExtents[i].size == 0) {
+            memmove(largeObjectExtents + i, largeObjectExtents + i + 1, (--largeObjectExtentCount - i) * sizeof(LargeObjectExtent));
+        }
+    }
+    else if (largeObjectSpaceTop + size > oldGenerationMaximum) {
+        return NULL;
+    }
+    else {
+        largeObjectSpaceTop += size;
+    }
+    
+    if (mprotect(largeObjectSpace + offset, size, PROT_READ | PROT_WRITE) != 0) {
+        error("Cannot commit heap memory!");
+    }
+    return largeObjectSpace + offset;
+}
+
+/** Decommits the pages of the given large object and makes them available again. */
+static void largeObjectSpaceFree(Object *o){
+    size_t size = alignToPage(objectSize(o));
+    size_t offset = (Byte *)o - largeObjectSpace;
+    madvise(o, size, MADV_DONTNEED);
+    mprotect(o, size, PROT_NONE);
+    largeObjectUse -= size;
+    
+    size_t i = 0;
+    while (i < largeObjectExtentCount && largeObjectExtents[i].offset < offset) {
+        i++;
+    }
+    
+    //Merge with the adjacent free ranges
+    if (i < largeObjectExtentCount && offset + size == largeObjectExtents[i].offset) {
+        largeObjectExtents[i].offset = offset;
+        largeObjectExtents[i].size += size;
+    }
+    else {
+        if (largeObjectExtentCount == largeObjectExtentCapacity) {
+            largeObjectExtentCapacity = largeObjectExtentCapacity ? largeObjectExtentCapacity * 2 : 16;
+            largeObjectExtents = realloc(largeObjectExtents, largeObjectExtentCapacity * sizeof(LargeObjectExtent));
+            if (!largeObjectExtents) {
+                error("Cannot allocate large object space!");
+            }
+        }
+        memmove(largeObjectExtents + i + 1, largeObjectExtents + i, (largeObjectExtentCount++ - i) * sizeof(LargeObjectExtent));
+        largeObjectExtents[i].offset = offset;
+        largeObjectExtents[i].size = size;
+    }
+    if (i > 0 && largeObjectExtents[i - 1].offset + largeObjectExtents[i - 1].size == offset) {
+        largeObjectExtents[i - 1].size += largeObjectExtents[i].size;
+        memmove(largeObjectExtents + i, largeObjectExtents + i + 1, (--largeObjectExtentCount - i) * sizeof(LargeObjectExtent));
+        i--;
+    }
+    
+    //Free ranges at the top give back address space to the bump allocator
+    if (largeObjectExtents[i].offset + largeObjectExtents[i].size == largeObjectSpaceTop) {
+        largeObjectSpaceTop = largeObjectExtents[i].offset;
+        largeObjectExtentCount--;
+    }
+}
+
+/** Takes @c size bytes of pages for a large object and registers it. Returns @c NULL if there is not enough space. */
+static Byte* largeObjectSpaceTake(size_t size){
+    pthread_mutex_lock(&heapMutex);
+    Byte *block = largeObjectSpaceAllocate(size);
+    if (block) {
+        largeObjectUse += size;
+        registryAppend(&largeObjects, (Object *)block);
+    }
+    pthread_mutex_unlock(&heapMutex);
+    return block;
+}
+
+/** Allocates a large object, which is already cleared as it lives on fresh pages. */
+static Byte* allocateLargeObject(size_t size, Thread *thread){
+    size = alignToPage(size);
+    if (largeObjectUse + size > largeObjectLimit) {
+        gc(thread);
+        pthread_mutex_lock(&heapMutex);
+        if (largeObjectUse + size > largeObjectLimit) {
+            largeObjectLimit = largeObjectUse + size;
         }
-        gc(mainThread);
+        pthread_mutex_unlock(&heapMutex);
     }
+    
+    Byte *block = largeObjectSpaceTake(size);
+    if (!block) {
+        gc(thread);
+        block = largeObjectSpaceTake(size);
+    }
+    if (!block) {
+        error("Allocation of %ld bytes is too big. Try to enlarge the heap. (Heap size: %ld)", size, 2 * oldGenerationMaximum);
+    }
+    return block;
+}
+
+/**
+ * Takes @c size bytes from the nursery. Blocks up to @c allocationBufferSize are allocated in a new allocation buffer
+ * of the thread. The nursery is collected if it is exhausted.
+ */
+static Byte* allocateInNursery(size_t size, Thread *thread){
+    while (true) {
+        pthread_mutex_lock(&heapMutex);
+        if (size > allocationBufferSize && nurseryUse + size <= nurserySize) {
+            Byte *block = nursery + nurseryUse;
+            nurseryUse += size;
+            pthread_mutex_unlock(&heapMutex);
+            return block;
+        }
+        if (size <= allocationBufferSize && nurseryUse + size <= nurserySize) {
+            size_t bufferSize = nurserySize - nurseryUse < allocationBufferSize ? nurserySize - nurseryUse : allocationBufferSize;
+            thread->allocationPointer = nursery + nurseryUse;
+            thread->allocationLimit = thread->allocationPointer + bufferSize;
+            nurseryUse += bufferSize;
+            pthread_mutex_unlock(&heapMutex);
+            
+            Byte *block = thread->allocationPointer;
+            thread->allocationPointer += size;
+            return block;
+        }
+        pthread_mutex_unlock(&heapMutex);
+        
+        collectNursery(thread);
+    }
+}
+
+/** Allocates a block of memory that is not yet cleared. */
+static Byte* allocate(size_t size){
+    Thread *thread = currentThread;
+    if (size > largeObjectThreshold) {
+        return allocateLargeObject(size, thread);
+    }
+    
+    if ((size_t)(thread->allocationLimit - thread->allocationPointer) >= size) {
+        Byte *block = thread->allocationPointer;
+        thread->allocationPointer += size;
+        return block;
+    }
+    return allocateInNursery(size, thread);
+}
+
+/**
+ * Allocates a zeroed block of memory. The heap itself is never cleared, which keeps the cost of a collection
+ * independent of the amount of garbage, so only the memory handed out is cleared here.
+ */
+static void* emojicodeMalloc(size_t size){
+    Byte *block = allocate(size);
+    if (!isLargeObject(block)) {
+        memset(block, 0, size);
+    }
+    return block;
+}
+
+/** Allocates the space for a surviving object during a collection or for an integer box. */
+static void* copyMalloc(size_t size){
+    if (memoryUse + size > oldGenerationMaximum) {
+        error("Terminating program due to too high memory pressure.");
+    }
+    commitOldGeneration(memoryUse + size);
     Byte *block = currentHeap + memoryUse;
     memoryUse += size;
     return block;
 }
 
 static void* emojicodeRealloc(void *ptr, size_t oldSize, size_t newSize){
+    Thread *thread = currentThread;
+    
     //Nothing has been allocated since the allocation of ptr
-    if (ptr == currentHeap + memoryUse - oldSize) {
-        memoryUse += newSize - oldSize;
-        return ptr;
+    if (isInNursery(ptr)) {
+        if ((Byte *)ptr + oldSize == thread->allocationPointer && newSize <= largeObjectThreshold
+            && (size_t)(thread->allocationLimit - thread->allocationPointer) >= newSize - oldSize) {
+            thread->allocationPointer += newSize - oldSize;
+            memset((Byte *)ptr + oldSize, 0, newSize - oldSize);
+            return ptr;
+        }
+    }
+    else if (!isLargeObject(ptr)) {
+        pthread_mutex_lock(&heapMutex);
+        if (ptr == currentHeap + memoryUse - oldSize && memoryUse + nurserySize + newSize - oldSize <= oldGenerationLimit
+            && newSize <= largeObjectThreshold) {
+            commitOldGeneration(memoryUse + newSize - oldSize);
+            memoryUse += newSize - oldSize;
+            pthread_mutex_unlock(&heapMutex);
+            memset((Byte *)ptr + oldSize, 0, newSize - oldSize);
+            return ptr;
+        }
+        pthread_mutex_unlock(&heapMutex);
     }
     
-    void *block = emojicodeMalloc(newSize);
-    memcpy(block, ptr, oldSize);
+    //The allocation might collect garbage and move ptr
+    stackPush(ptr, 0, 0, thread);
+    Byte *block = allocate(newSize);
+    memcpy(block, stackGetThis(thread), oldSize);
+    memset(block + oldSize, 0, newSize - oldSize);
+    stackPop(thread);
     return block;
 }
 
 static Object* newObjectWithSizeInternal(Class *class, size_t size){
-    size_t fullSize = sizeof(Object) + size;
+    size_t fullSize = alignSize(sizeof(Object) + size);
     Object *object = emojicodeMalloc(fullSize);
     object->size = fullSize;
     object->class = class;
-    object->value = ((Byte *)object) + sizeof(Object) + class->instanceVariableCount * sizeof(Something);
+    
+    if (class->deconstruct) {
+        pthread_mutex_lock(&heapMutex);
+        registryAppend(isInNursery(object) ? &youngFinalizables : &oldFinalizables, object);
+        pthread_mutex_unlock(&heapMutex);
+    }
     
     return object;
 }
 
 Something objectGetVariable(Object *o, uint8_t index){
-    return *(Something *)(((Byte *)o) + sizeof(Object) + sizeof(Something) * index);
+    return objectVariables(o)[index];
 }
 
 void objectSetVariable(Object *o, uint8_t index, Something value){
-    Something *v = (Something *)(((Byte *)o) + sizeof(Object) + sizeof(Something) * index);
-    *v = value;
+    objectVariables(o)[index] = value;
+    writeBarrier(o, value);
 }
 
 void objectDecrementVariable(Object *o, uint8_t index){
-    ((Something *)(((Byte *)o) + sizeof(Object) + sizeof(Something) * index))->raw--;
+    //Integer boxes are allocated in the old generation and do not need the write barrier
+    objectVariables(o)[index] = somethingInteger(unwrapInteger(objectVariables(o)[index]) - 1);
 }
 
 void objectIncrementVariable(Object *o, uint8_t index){
-    ((Something *)(((Byte *)o) + sizeof(Object) + sizeof(Something) * index))->raw++;
+    objectVariables(o)[index] = somethingInteger(unwrapInteger(objectVariables(o)[index]) + 1);
+}
+
+/** The class of integer boxes. Boxes have no instance variables and contain nothing the GC must follow. */
+static Class integerBoxClass = { .size = sizeof(EmojicodeInteger), .valueSize = sizeof(EmojicodeInteger) };
+
+bool collectionRequested = false;
+
+/**
+ * Integers that do not fit into a Something are boxed in the old generation directly. This way boxing can never
+ * trigger a collection and boxes never need the write barrier, as they do not reference other objects.
+ */
+Object* boxInteger(EmojicodeInteger i){
+    pthread_mutex_lock(&heapMutex);
+    Object *box = copyMalloc(alignSize(sizeof(Object) + sizeof(EmojicodeInteger)));
+    box->class = &integerBoxClass;
+    box->size = alignSize(sizeof(Object) + sizeof(EmojicodeInteger));
+    *(EmojicodeInteger *)objectValue(box) = i;
+    
+    if (memoryUse + nurseryUse > oldGenerationLimit) {
+        collectionRequested = true;
+        safepointRequested = true;
+    }
+    pthread_mutex_unlock(&heapMutex);
+    return box;
+}
+
+EmojicodeInteger unboxInteger(Object *box){
+    return *(EmojicodeInteger *)objectValue(box);
+}
+
+bool isIntegerBox(Object *o){
+    return o->class == &integerBoxClass;
+}
+
+//MARK: Identity hashes
+
+/** An object whose identity hash was requested together with that hash. */
+typedef struct {
+    Object *object;
+    uint64_t hash;
+} IdentityHash;
+
+/** An open-addressing table of identity hashes keyed by the address of the objects. */
+typedef struct {
+    IdentityHash *entries;
+    size_t capacity;
+    size_t count;
+} IdentityHashTable;
+
+/**
+ * The identity hashes of objects in the nursery and of all other objects. Objects are moved by collections, but a
+ * nursery collection only moves the young ones, so only the young table is emptied into the old table then. The old
+ * table is rebuilt by full collections.
+ */
+static IdentityHashTable youngIdentityHashes;
+static IdentityHashTable oldIdentityHashes;
+static uint64_t nextIdentityHash = 1;
+
+#define identityHashBucket(o, capacity) (((uintptr_t)(o) >> 3) * 0x9E3779B97F4A7C15ULL >> 20 & ((capacity) - 1))
+
+static void identityHashesInsert(IdentityHashTable *table, IdentityHash entry){
+    size_t i = identityHashBucket(entry.object, table->capacity);
+    while (table->entries[i].object) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    table->entries[i] = entry;
+    table->count++;
+}
+
+/** Moves all entries into a new table of the given capacity. Entries are kept if @c move returns a location. */
+static void identityHashesRebuild(IdentityHashTable *table, size_t capacity, Object* (*move)(Object *)){
+    IdentityHashTable rebuilt = { calloc(capacity, sizeof(IdentityHash)), capacity, 0 };
+    if (!rebuilt.entries) {
+        error("Cannot allocate identity hash table!");
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        Object *o = table->entries[i].object;
+        if (o && (o = move(o))) {
+            identityHashesInsert(&rebuilt, (IdentityHash){ o, table->entries[i].hash });
+        }
+    }
+    free(table->entries);
+    *table = rebuilt;
+}
+
+static Object* identityHashesKeep(Object *o){
+    return o;
+}
+
+/** Makes room for one more entry. */
+static void identityHashesReserve(IdentityHashTable *table){
+    if (2 * (table->count + 1) > table->capacity) {
+        identityHashesRebuild(table, table->capacity ? table->capacity * 2 : 64, identityHashesKeep);
+    }
+}
+
+uint64_t objectIdentityHash(Object *object){
+    pthread_mutex_lock(&heapMutex);
+    IdentityHashTable *table = isInNursery(object) ? &youngIdentityHashes : &oldIdentityHashes;
+    if (table->capacity) {
+        for (size_t i = identityHashBucket(object, table->capacity); table->entries[i].object;
+             i = (i + 1) & (table->capacity - 1)) {
+            if (table->entries[i].object == object) {
+                uint64_t hash = table->entries[i].hash;
+                pthread_mutex_unlock(&heapMutex);
+                return hash;
+            }
+        }
+    }
+    
+    identityHashesReserve(table);
+    uint64_t hash = nextIdentityHash++;
+    identityHashesInsert(table, (IdentityHash){ object, hash });
+    pthread_mutex_unlock(&heapMutex);
+    return hash;
 }
 
 Object* newObject(Class *class){
@@ -75,83 +530,442 @@ Object* newArray(size_t size){
 }
 
 Object* resizeArray(Object *array, size_t size){
-    size_t fullSize = sizeof(Object) + size;
-    Object *object = emojicodeRealloc(array, array->size, fullSize);
+    size_t fullSize = alignSize(sizeof(Object) + size);
+    Object *object = emojicodeRealloc(array, objectSize(array), fullSize);
     object->size = fullSize;
-    object->value = ((Byte *)object) + sizeof(Object);
     return object;
 }
 
+/**
+ * Reads a size in bytes, optionally followed by K, M or G, from the given environment variable. The suffixes are
+ * decimal like the sizes passed to make, i.e. K stands for 1000 bytes.
+ */
+static size_t sizeFromEnvironment(const char *name, size_t defaultValue){
+    char *value = getenv(name);
+    if (!value) {
+        return defaultValue;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long size = strtoull(value, &end, 10);
+    if (end == value || !isdigit((unsigned char)*value) || errno == ERANGE) {
+        error("%s must be a size in bytes, but is “%.100s”.", name, value);
+    }
+    unsigned long long multiplier = 1;
+    switch (*end) {
+        case 'G': case 'g':
+            multiplier *= 1000;
+            //Fall through
+        case 'M': case 'm':
+            multiplier *= 1000;
+            //Fall through
+        case 'K': case 'k':
+            multiplier *= 1000;
+            end++;
+            break;
+    }
+    if (*end != 0) {
+        error("%s must end in K, M or G if it has a suffix, but is “%.100s”.", name, value);
+    }
+    if (size > SIZE_MAX / multiplier) {
+        error("%s is too big.", name);
+    }
+    return (size_t)(size * multiplier);
+}
+
 void allocateHeap(){
-    currentHeap = calloc(heapSize, 1);
-    if (!currentHeap) {
+    char *statistics = getenv("EMOJICODE_GC_STATS");
+    if (statistics) {
+        gcEventLog = strcmp(statistics, "json") == 0;
+        atexit(reportGCStatistics);
+    }
+    
+    size_t maximumHeapSize = sizeFromEnvironment("EMOJICODE_HEAP_SIZE", heapSize);
+    size_t initialSize = sizeFromEnvironment("EMOJICODE_HEAP_INITIAL_SIZE", initialHeapSize);
+    char *growth = getenv("EMOJICODE_HEAP_GROWTH");
+    if (growth) {
+        //The engine is built with -Ofast, which assumes that doubles are finite, so NaN and infinity are rejected by
+        //only accepting decimal digits and a point
+        char *end;
+        heapGrowthFactor = strtod(growth, &end);
+        if (end == growth || *end != 0 || growth[strspn(growth, "0123456789.")] != 0 || heapGrowthFactor < 1) {
+            error("EMOJICODE_HEAP_GROWTH must be a number of at least 1, but is “%.100s”.", growth);
+        }
+    }
+    
+    oldGenerationMaximum = alignToGranularity(maximumHeapSize / 2);
+    initialOldGenerationLimit = initialSize / 2 > oldGenerationMaximum ? oldGenerationMaximum : initialSize / 2;
+    if (initialOldGenerationLimit < nurserySize) {
+        initialOldGenerationLimit = nurserySize;
+    }
+    oldGenerationLimit = initialOldGenerationLimit;
+    largeObjectLimit = initialOldGenerationLimit;
+    if (nurserySize > oldGenerationMaximum) {
+        error("The heap must be at least twice as big as the nursery.");
+    }
+    
+    pageSize = sysconf(_SC_PAGESIZE);
+    
+    size_t nurseryReservation = alignToGranularity(nurserySize);
+    nursery = mmap(NULL, nurseryReservation + 3 * oldGenerationMaximum, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (nursery == MAP_FAILED || mprotect(nursery, nurseryReservation, PROT_READ | PROT_WRITE) != 0) {
         error("Cannot allocate heap!");
     }
-    otherHeap = currentHeap + (heapSize / 2);
+    currentHeap = nursery + nurseryReservation;
+    otherHeap = currentHeap + oldGenerationMaximum;
+    largeObjectSpace = otherHeap + oldGenerationMaximum;
+    heapEnd = largeObjectSpace + oldGenerationMaximum;
+    
+    //Object references must fit into the lower 48 bits of a Something
+    if ((uintptr_t)heapEnd >> 48) {
+        error("The heap was mapped outside of the 48-bit address space!");
+    }
+}
+
+void writeBarrier(Object *owner, Something value){
+    if (isRealObject(value) && isInNursery(value.object) && !isInNursery(owner) && !(owner->size & REMEMBERED_FLAG)) {
+        pthread_mutex_lock(&heapMutex);
+        if (!(owner->size & REMEMBERED_FLAG)) {
+            owner->size |= REMEMBERED_FLAG;
+            registryAppend(&rememberedSet, owner);
+        }
+        pthread_mutex_unlock(&heapMutex);
+    }
+}
+
+/** Marks all objects the given object references. */
+static void scan(Object *o){
+    gcStatistics.bytesScanned += objectSize(o);
+    
+    Something *variables = objectVariables(o);
+    for (uint_fast16_t i = 0; i < o->class->instanceVariableCount; i++) {
+        if (isRealObject(variables[i])) {
+            mark(&variables[i].object);
+        }
+    }
+    
+    //This class can lead the GC to other objects.
+    if (o->class->mark) {
+        o->class->mark(o);
+    }
 }
 
 void mark(Object **oPointer){
     Object *o = *oPointer;
-    if (o->newLocation) {
-        *oPointer = o->newLocation;
+    if (collectingNursery && !isInNursery(o)) {
+        return;
+    }
+    if (isForwarded(o)) {
+        *oPointer = forwardingAddress(o);
         return;
     }
     
-    o->newLocation = emojicodeMalloc(o->size);
+    //Large objects are not moved but marked
+    if (isLargeObject(o)) {
+        if (!(o->size & MARKED_FLAG)) {
+            o->size |= MARKED_FLAG;
+            registryAppend(&largeObjectsToScan, o);
+        }
+        return;
+    }
     
-    memcpy(o->newLocation, o, o->size);
-    *oPointer = o->newLocation;
+    size_t size = objectSize(o);
+    Object *copy = copyMalloc(size);
+    gcStatistics.bytesCopied += size;
     
-    o->newLocation->value = ((Byte *)o->newLocation) + sizeof(Object) + o->class->instanceVariableCount * sizeof(Something);
+    memcpy(copy, o, size);
+    copy->size = size;
+    o->class = (Class *)((uintptr_t)copy | 1);
+    *oPointer = copy;
+}
+
+/** Returns the location of the given object after the current collection or @c NULL if it is garbage. */
+static Object* survivor(Object *o){
+    if (isForwarded(o)) {
+        return forwardingAddress(o);
+    }
+    return o->size & MARKED_FLAG ? o : NULL;
+}
+
+/**
+ * Scans the objects copied into the old generation from @c scanned on. Scanning copies further objects behind the
+ * scan pointer, so this visits the object graph breadth-first without using the native stack.
+ */
+static void scanCopies(size_t scanned){
+    do {
+        while (scanned < memoryUse) {
+            Object *o = (Object *)(currentHeap + scanned);
+            scanned += objectSize(o);
+            scan(o);
+        }
+        while (largeObjectsToScan.count > 0) {
+            scan(largeObjectsToScan.objects[--largeObjectsToScan.count]);
+        }
+    } while (scanned < memoryUse);
+}
+
+/** Frees all large objects that were not marked and unmarks the others. */
+static void sweepLargeObjects(){
+    size_t survivors = 0;
+    for (size_t i = 0; i < largeObjects.count; i++) {
+        Object *o = largeObjects.objects[i];
+        if (o->size & MARKED_FLAG) {
+            //The nursery is empty after a full collection
+            o->size &= ~(MARKED_FLAG | REMEMBERED_FLAG);
+            largeObjects.objects[survivors++] = o;
+        }
+        else {
+            largeObjectSpaceFree(o);
+        }
+    }
+    largeObjects.count = survivors;
+}
+
+static void markRoots(){
+    threadsMarkStacks();
     
-    //This class can lead the GC to other objects.
-    if (o->class->mark) {
-        o->class->mark(o->newLocation);
+    for (uint_fast16_t i = 0; i < stringPoolCount; i++) {
+        if (stringPool[i]) {
+            mark(stringPool + i);
+        }
     }
 }
 
-void gc(Thread *thread){
-    if (zeroingNeeded) {
-        memset(otherHeap, 0, heapSize / 2);
+/** Returns the location of @c o after a nursery collection or @c NULL if it is garbage. */
+static Object* nurserySurvivor(Object *o){
+    if (!isInNursery(o)) {
+        return o;
     }
-    else {
-        zeroingNeeded = true;
+    return isForwarded(o) ? forwardingAddress(o) : NULL;
+}
+
+/** Moves the identity hashes of the objects that survived a nursery collection to the old table. */
+static void promoteIdentityHashes(){
+    if (youngIdentityHashes.count == 0) {
+        return;
+    }
+    for (size_t i = 0; i < youngIdentityHashes.capacity; i++) {
+        Object *o = youngIdentityHashes.entries[i].object;
+        if (o && (o = nurserySurvivor(o))) {
+            identityHashesReserve(&oldIdentityHashes);
+            identityHashesInsert(&oldIdentityHashes, (IdentityHash){ o, youngIdentityHashes.entries[i].hash });
+        }
     }
+    memset(youngIdentityHashes.entries, 0, youngIdentityHashes.capacity * sizeof(IdentityHash));
+    youngIdentityHashes.count = 0;
+}
+
+/** Rebuilds the old identity hash table with the new locations of all objects and forgets the dead ones. */
+static void updateIdentityHashes(){
+    //The nursery is evacuated as well
+    for (size_t i = 0; i < youngIdentityHashes.capacity; i++) {
+        Object *o = youngIdentityHashes.entries[i].object;
+        if (o) {
+            identityHashesReserve(&oldIdentityHashes);
+            identityHashesInsert(&oldIdentityHashes, youngIdentityHashes.entries[i]);
+        }
+    }
+    memset(youngIdentityHashes.entries, 0, youngIdentityHashes.capacity * sizeof(IdentityHash));
+    youngIdentityHashes.count = 0;
     
-    //Set new location of all objects to NULL
-    Byte *currentObjectPointer = currentHeap;
-    while (currentObjectPointer < currentHeap + memoryUse - 1) {
-        Object *currentObject = (Object *)currentObjectPointer;
-        currentObject->newLocation = NULL;
-        currentObjectPointer += currentObject->size;
+    if (oldIdentityHashes.count == 0) {
+        return;
+    }
+    size_t capacity = oldIdentityHashes.capacity;
+    while (capacity > 64 && 8 * oldIdentityHashes.count < capacity) {
+        capacity /= 2;
+    }
+    identityHashesRebuild(&oldIdentityHashes, capacity, survivor);
+}
+
+/**
+ * Calls the deinitializers of all objects in the nursery that were not copied. The new locations of the surviving
+ * objects are registered with the old generation.
+ */
+static void finalizeNursery(){
+    for (size_t i = 0; i < youngFinalizables.count; i++) {
+        Object *o = youngFinalizables.objects[i];
+        if (isForwarded(o)) {
+            registryAppend(&oldFinalizables, forwardingAddress(o));
+        }
+        else {
+            o->class->deconstruct(objectValue(o));
+            gcStatistics.objectsFinalized++;
+        }
+    }
+    youngFinalizables.count = 0;
+}
+
+/** Calls the deinitializers of all objects in the old generation that were not copied. */
+static void finalizeOldGeneration(){
+    size_t survivors = 0;
+    for (size_t i = 0; i < oldFinalizables.count; i++) {
+        Object *o = oldFinalizables.objects[i];
+        Object *newLocation = survivor(o);
+        if (newLocation) {
+            oldFinalizables.objects[survivors++] = newLocation;
+        }
+        else {
+            o->class->deconstruct(objectValue(o));
+            gcStatistics.objectsFinalized++;
+        }
+    }
+    oldFinalizables.count = survivors;
+}
+
+static uint64_t nanoseconds(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+size_t heapOccupancy(){
+    return nurseryUse + memoryUse + largeObjectUse;
+}
+
+/** Records the pause of a collection that started at @c start. */
+static void recordCollection(const char *kind, uint64_t start, uint64_t scanned, uint64_t copied, uint64_t finalized){
+    uint64_t pause = nanoseconds() - start;
+    gcStatistics.pauseNanoseconds += pause;
+    if (pause > gcStatistics.maximumPauseNanoseconds) {
+        gcStatistics.maximumPauseNanoseconds = pause;
     }
     
+    uint_fast8_t bucket = 0;
+    for (uint64_t bound = 100000; bucket < gcPauseHistogramSize - 1 && pause >= bound; bound *= 10) {
+        bucket++;
+    }
+    gcStatistics.pauseHistogram[bucket]++;
+    
+    if (gcEventLog) {
+        fprintf(stderr, "{\"event\": \"%s\", \"pauseNs\": %" PRIu64 ", \"bytesScanned\": %" PRIu64
+                ", \"bytesCopied\": %" PRIu64 ", \"objectsFinalized\": %" PRIu64 ", \"occupancy\": %zu"
+                ", \"oldGenerationLimit\": %zu, \"largeObjectLimit\": %zu}\n", kind, pause,
+                gcStatistics.bytesScanned - scanned, gcStatistics.bytesCopied - copied,
+                gcStatistics.objectsFinalized - finalized, heapOccupancy(), oldGenerationLimit, largeObjectLimit);
+    }
+}
+
+void reportGCStatistics(){
+    GCStatistics *s = &gcStatistics;
+    uint64_t collections = s->nurseryCollections + s->fullCollections;
+    fprintf(stderr, "GC: %" PRIu64 " collections (%" PRIu64 " nursery, %" PRIu64 " full), %.3f ms total pause, "
+            "%.3f ms maximum pause\n", collections, s->nurseryCollections, s->fullCollections,
+            s->pauseNanoseconds / 1e6, s->maximumPauseNanoseconds / 1e6);
+    fprintf(stderr, "GC: pauses < 100 us: %" PRIu64 ", < 1 ms: %" PRIu64 ", < 10 ms: %" PRIu64 ", < 100 ms: %" PRIu64
+            ", >= 100 ms: %" PRIu64 "\n", s->pauseHistogram[0], s->pauseHistogram[1], s->pauseHistogram[2],
+            s->pauseHistogram[3], s->pauseHistogram[4]);
+    fprintf(stderr, "GC: %" PRIu64 " bytes scanned, %" PRIu64 " bytes copied, %" PRIu64 " objects finalized\n",
+            s->bytesScanned, s->bytesCopied, s->objectsFinalized);
+    fprintf(stderr, "GC: %.2f%% nursery survival rate, %zu bytes occupied, %zu bytes committed\n",
+            s->nurseryBytesCollected ? 100.0 * s->nurseryBytesSurvived / s->nurseryBytesCollected : 0.0,
+            heapOccupancy(), alignToGranularity(nurserySize) + currentHeapCommitted + largeObjectUse);
+}
+
+static void collectEverything(void);
+
+/** Collects the nursery, or everything if the old generation might not be able to take all survivors. */
+static void collectYoungGeneration(){
+    if (memoryUse + nurseryUse > oldGenerationLimit) {
+        collectEverything();
+        return;
+    }
+    
+    uint64_t start = nanoseconds();
+    uint64_t scannedBefore = gcStatistics.bytesScanned, copiedBefore = gcStatistics.bytesCopied;
+    uint64_t finalizedBefore = gcStatistics.objectsFinalized;
+    
+    collectingNursery = true;
+    
+    size_t scanned = memoryUse;
+    markRoots();
+    for (size_t i = 0; i < rememberedSet.count; i++) {
+        Object *o = rememberedSet.objects[i];
+        o->size &= ~REMEMBERED_FLAG;
+        scan(o);
+    }
+    rememberedSet.count = 0;
+    scanCopies(scanned);
+    
+    collectingNursery = false;
+    
+    promoteIdentityHashes();
+    finalizeNursery();
+    
+    gcStatistics.nurseryCollections++;
+    gcStatistics.nurseryBytesCollected += nurseryUse;
+    gcStatistics.nurseryBytesSurvived += gcStatistics.bytesCopied - copiedBefore;
+    nurseryUse = 0;
+    threadsResetAllocationBuffers();
+    recordCollection("nursery", start, scannedBefore, copiedBefore, finalizedBefore);
+}
+
+static void collectEverything(){
+    uint64_t start = nanoseconds();
+    uint64_t scannedBefore = gcStatistics.bytesScanned, copiedBefore = gcStatistics.bytesCopied;
+    uint64_t finalizedBefore = gcStatistics.objectsFinalized;
+    
     void *tempHeap = currentHeap;
     currentHeap = otherHeap;
     otherHeap = tempHeap;
-    size_t oldMemoryUse = memoryUse;
+    size_t tempCommitted = currentHeapCommitted;
+    currentHeapCommitted = otherHeapCommitted;
+    otherHeapCommitted = tempCommitted;
     memoryUse = 0;
     
+    //The nursery is evacuated as well, so the remembered set becomes obsolete
+    rememberedSet.count = 0;
+    
     //Mark from rootset
-    stackMark(thread);
+    markRoots();
+    scanCopies(0);
     
-    for (uint_fast16_t i = 0; i < stringPoolCount; i++) {
-        mark(stringPool + i);
-    }
+    updateIdentityHashes();
     
     //Call the deinitializers
-    currentObjectPointer = otherHeap;
-    while (currentObjectPointer < otherHeap + oldMemoryUse) {
-        Object *currentObject = (Object *)currentObjectPointer;
-        if(!currentObject->newLocation && currentObject->class->deconstruct){
-            currentObject->class->deconstruct(currentObject->value);
-        }
-        currentObjectPointer += currentObject->size;
-    }
+    finalizeOldGeneration();
+    finalizeNursery();
+    nurseryUse = 0;
+    threadsResetAllocationBuffers();
+    
+    sweepLargeObjects();
+    decommitOtherHeap();
    
-    if (oldMemoryUse == memoryUse) {
+    if (memoryUse + nurserySize > oldGenerationMaximum) {
         error("Terminating program due to too high memory pressure.");
     }
+    
+    //Let the heap grow or shrink with the live data
+    double limit = memoryUse * heapGrowthFactor + nurserySize;
+    if (limit > oldGenerationMaximum) {
+        limit = oldGenerationMaximum;
+    }
+    oldGenerationLimit = limit < initialOldGenerationLimit ? initialOldGenerationLimit : (size_t)limit;
+    
+    limit = largeObjectUse * heapGrowthFactor;
+    if (limit > SIZE_MAX / 2) {
+        limit = SIZE_MAX / 2;
+    }
+    largeObjectLimit = limit < initialOldGenerationLimit ? initialOldGenerationLimit : (size_t)limit;
+    
+    collectionRequested = false;
+    gcStatistics.fullCollections++;
+    recordCollection("full", start, scannedBefore, copiedBefore, finalizedBefore);
+}
+
+/** Collects the nursery unless another thread collected meanwhile. */
+static void collectNursery(Thread *thread){
+    if (stopTheWorld(thread)) {
+        collectYoungGeneration();
+        resumeTheWorld();
+    }
+}
+
+void gc(Thread *thread){
+    if (stopTheWorld(thread)) {
+        collectEverything();
+        resumeTheWorld();
+    }
 }
 
 bool instanceof(Object *object, Class *class){
@@ -159,5 +973,6 @@ bool instanceof(Object *object, Class *class){
 }
 
 bool isPossibleObjectPointer(void *s){
-    return (Byte *)s < currentHeap + heapSize/2 && s >= (void *)currentHeap;
+    //During a collection pointers into both semispaces must be recognized
+    return (Byte *)s >= nursery && (Byte *)s < heapEnd;
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+//
+//  Parallel.c
+//  Emojicode
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "Emojicode.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+/** Chunks are never smaller than this to amortize the scheduling. */
+#define minimumChunkSize 512
+/** Every thread should get several chunks so that threads that finish early can help the others. */
+#define chunksPerThread 4
+
+/** The number of threads that process parallel jobs, including the thread that started the job. */
+static size_t threadCount = 0;
+
+static pthread_once_t workersStarted = PTHREAD_ONCE_INIT;
+/** Held while a job runs, as there is only one pool for all threads. */
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t jobMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobAvailable = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t jobFinished = PTHREAD_COND_INITIALIZER;
+/** Incremented for every job, workers wait until it changes. */
+static uint64_t jobGeneration = 0;
+/** The number of workers that have not finished the current job. */
+static size_t busyWorkers = 0;
+
+static struct {
+    ParallelBody body;
+    void *context;
+    size_t count;
+    size_t chunkSize;
+    /** The first index that was not claimed by a thread yet. */
+    atomic_size_t next;
+} job;
+
+/** Claims and processes chunks of the current job until none are left. */
+static void processChunks(Thread *thread){
+    while (true) {
+        size_t from = atomic_fetch_add(&job.next, job.chunkSize);
+        if (from >= job.count) {
+            return;
+        }
+        size_t to = from + job.chunkSize < job.count ? from + job.chunkSize : job.count;
+        job.body(job.context, from, to, from / job.chunkSize, thread);
+    }
+}
+
+static void* workerMain(void *argument){
+    Thread *thread = currentThread = argument;
+    uint64_t generation = 0;
+
+    pthread_mutex_lock(&jobMutex);
+    while (true) {
+        while (jobGeneration == generation) {
+            pthread_cond_wait(&jobAvailable, &jobMutex);
+        }
+        generation = jobGeneration;
+        pthread_mutex_unlock(&jobMutex);
+
+        processChunks(thread);
+
+        pthread_mutex_lock(&jobMutex);
+        if (--busyWorkers == 0) {
+            pthread_cond_signal(&jobFinished);
+        }
+    }
+    return NULL;
+}
+
+/** Determines the number of threads and starts the workers. */
+static void startWorkers(){
+    char *workers = getenv("EMOJICODE_WORKERS");
+    long count = workers ? strtol(workers, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    threadCount = count > 0 ? (size_t)count : 1;
+
+    for (size_t i = 1; i < threadCount; i++) {
+        //Workers stay in their blocking region as they only access the heap while a job keeps the world running
+        Thread *thread = allocateThread();
+        thread->safepointsDisabled = true;
+        
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, workerMain, thread) != 0) {
+            threadCount = i;
+            break;
+        }
+        pthread_detach(worker);
+    }
+}
+
+size_t parallelChunkSize(size_t count){
+    pthread_once(&workersStarted, startWorkers);
+    size_t chunkSize = count / (threadCount * chunksPerThread);
+    return chunkSize < minimumChunkSize ? minimumChunkSize : chunkSize;
+}
+
+bool parallelWorthwhile(size_t count){
+    pthread_once(&workersStarted, startWorkers);
+    return threadCount > 1 && count > minimumChunkSize;
+}
+
+void parallelFor(size_t count, size_t chunkSize, ParallelBody body, void *context, Thread *thread){
+    pthread_once(&workersStarted, startWorkers);
+    pthread_mutex_lock(&poolMutex);
+
+    job.body = body;
+    job.context = context;
+    job.count = count;
+    job.chunkSize = chunkSize;
+    atomic_store(&job.next, 0);
+
+    //The thread keeps running until the job is done, so no collection can be performed meanwhile
+    bool safepointsDisabled = thread->safepointsDisabled;
+    thread->safepointsDisabled = true;
+    
+    pthread_mutex_lock(&jobMutex);
+    busyWorkers = threadCount - 1;
+    jobGeneration++;
+    pthread_cond_broadcast(&jobAvailable);
+    pthread_mutex_unlock(&jobMutex);
+
+    processChunks(thread);
+
+    pthread_mutex_lock(&jobMutex);
+    while (busyWorkers > 0) {
+        pthread_cond_wait(&jobFinished, &jobMutex);
+    }
+    pthread_mutex_unlock(&jobMutex);
+    pthread_mutex_unlock(&poolMutex);
+    
+    thread->safepointsDisabled = safepointsDisabled;
+}
@@ -7,6 +7,7 @@
 //
 
 #include "Emojicode.h"
+#include "EmojicodeString.h"
 #include <string.h>
 #include <dlfcn.h>
 
@@ -64,16 +65,20 @@ void readQualifiedTypeName(EmojicodeChar *name, EmojicodeChar *namespace, FILE *
     *namespace = readEmojicodeChar(in);
 }
 
-uint32_t readBlock(EmojicodeCoin **destination, uint8_t *variableCount, FILE *in){
+/**
+ * Reads a block of coins and schedules it for lowering. The instructions are available once
+ * @c lowerScheduledBlocks was called.
+ */
+void readBlock(Instruction **instructions, uint32_t *instructionCount, uint8_t *variableCount, uint32_t *hotness, FILE *in){
     *variableCount = fgetc(in);
     uint32_t coinCount = readEmojicodeChar(in);
 
-    *destination = malloc(sizeof(EmojicodeCoin) * coinCount);
+    EmojicodeCoin *coins = malloc(sizeof(EmojicodeCoin) * coinCount);
     for (uint32_t i = 0; i < coinCount; i++) {
-        (*destination)[i] = readCoin(in);
+        coins[i] = readCoin(in);
     }
     
-    return coinCount;
+    scheduleLowering(coins, coinCount, instructions, instructionCount, hotness);
 }
 
 void readInitializer(Class *class, EmojicodeChar className, FILE *in, hpfcResponder hpfc){
@@ -89,7 +94,7 @@ void readInitializer(Class *class, EmojicodeChar className, FILE *in, hpfcRespon
     }
     else {
         initializer->native = false;
-        initializer->tokenCount = readBlock(&initializer->tokenStream, &initializer->variableCount, in);
+        readBlock(&initializer->instructions, &initializer->instructionCount, &initializer->variableCount, NULL, in);
     }
     class->initializersVtable[vti] = initializer;
 }
@@ -107,7 +112,8 @@ void readMethod(Class *class, EmojicodeChar className, FILE *in, hpfmResponder h
     }
     else {
         method->native = false;
-        method->tokenCount = readBlock(&method->tokenStream, &method->variableCount, in);
+        method->jit = (JITState){ NULL, 0, false };
+        readBlock(&method->instructions, &method->instructionCount, &method->variableCount, &method->jit.hotness, in);
     }
     class->methodsVtable[vti] = method;
 }
@@ -125,7 +131,8 @@ void readClassMethod(Class *class, EmojicodeChar className, FILE *in, hpfcmRespo
     }
     else {
         method->native = false;
-        method->tokenCount = readBlock(&method->tokenStream, &method->variableCount, in);
+        method->jit = (JITState){ NULL, 0, false };
+        readBlock(&method->instructions, &method->instructionCount, &method->variableCount, &method->jit.hotness, in);
     }
     class->classMethodsVtable[vti] = method;
 }
@@ -245,7 +252,11 @@ void readPackage(FILE *in){
             class->deconstruct = class->superclass->deconstruct;
         }
         class->mark = mpfc(name);
-        class->size = sfch(class, name) + class->instanceVariableCount * sizeof(Something);
+        if(!class->mark && class->superclass){
+            class->mark = class->superclass->mark;
+        }
+        class->valueSize = (sfch(class, name) + 7) & ~(size_t)7;
+        class->size = class->valueSize + class->instanceVariableCount * sizeof(Something);
     } while(fgetc(in));
 }
 
@@ -269,23 +280,43 @@ ClassMethod* readBytecode(FILE *in, Class **cl){
     CL_DICTIONARY = classTable[5];
     CL_CAPTURED_METHOD_CALL = classTable[6];
     CL_CLOSURE = classTable[7];
+    CL_DICTIONARY_ENTRY_ENUMERATOR = classTable[8];
+    CL_DICTIONARY_VALUE_ENUMERATOR = classTable[9];
     
     stringPoolCount = readUInt16(in);
-    stringPool = malloc(sizeof(Object*) * stringPoolCount);
+    stringPool = calloc(stringPoolCount, sizeof(Object*));
     for (uint16_t i = 0; i < stringPoolCount; i++) {
-        Object *o = newObject(CL_STRING);
-        String *string = o->value;
-
-        string->length = readUInt16(in);
-        string->characters = newArray(string->length * sizeof(EmojicodeChar));
+        stringPool[i] = newObject(CL_STRING);
         
-        for (uint16_t j = 0; j < string->length; j++) {
-            ((EmojicodeChar*)string->characters->value)[j] = readEmojicodeChar(in);
+        uint16_t length = readUInt16(in);
+        EmojicodeChar *codePoints = malloc(length * sizeof(EmojicodeChar));
+        bool compact = true;
+        for (uint16_t j = 0; j < length; j++) {
+            codePoints[j] = readEmojicodeChar(in);
+            compact = compact && characterFitsCompact(codePoints[j]);
         }
-
-        stringPool[i] = o;
+        
+        Object *characters = newArray(stringStorageSize(length, compact));
+        
+        String *string = objectValue(stringPool[i]);
+        string->length = length;
+        string->characters = characters;
+        string->compact = compact;
+        writeBarrier(stringPool[i], somethingObject(characters));
+        
+        for (uint16_t j = 0; j < length; j++) {
+            if (compact) {
+                compactCharacters(string)[j] = (uint8_t)codePoints[j];
+            }
+            else {
+                wideCharacters(string)[j] = codePoints[j];
+            }
+        }
+        free(codePoints);
     }
     
+    lowerScheduledBlocks();
+    
     *cl = classTable[readUInt16(in)];
     uint16_t vtiFlag = readUInt16(in);
     
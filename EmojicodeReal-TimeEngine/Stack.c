@@ -11,24 +11,26 @@
 
 Thread* allocateThread() {
 #define stackSize (sizeof(StackFrame) + 4 * sizeof(Something)) * 10000 //ca. 400 KB
-    Thread *thread = malloc(sizeof(Thread));
+    Thread *thread = calloc(1, sizeof(Thread));
+    if (!thread) {
+        error("Could not allocate thread!");
+    }
     thread->stackLimit = malloc(stackSize);
-    thread->returned = false;
     if (!thread->stackLimit) {
         error("Could not allocate stack!");
     }
-    thread->futureStack = thread->stack = thread->stackBottom = thread->stackLimit + stackSize - 1;
+    thread->futureStack = thread->stack = thread->stackBottom = thread->stackLimit + stackSize;
+    threadRegister(thread);
     return thread;
 }
 
-Something* stackReserveFrame(void *this, uint8_t variableCount, Thread *thread){
+/** Reserves a frame whose variables are not initialized yet. */
+static StackFrame* reserveFrame(void *this, uint8_t variableCount, Thread *thread){
     StackFrame *sf = (StackFrame *)(thread->futureStack - (sizeof(StackFrame) + sizeof(Something) * variableCount));
     if ((Byte *)sf < thread->stackLimit) {
         error("Your program triggerd a stack overflow!");
     }
     
-    memset((Byte *)sf + sizeof(StackFrame), 0, sizeof(Something) * variableCount);
-    
     sf->this = this;
     sf->variableCount = variableCount;
     sf->returnPointer = thread->stack;
@@ -36,7 +38,14 @@ Something* stackReserveFrame(void *this, uint8_t variableCount, Thread *thread){
     
     thread->futureStack = (Byte *)sf;
     
-    return (Something *)(((Byte *)sf) + sizeof(StackFrame));
+    return sf;
+}
+
+Something* stackReserveFrame(void *this, uint8_t variableCount, Thread *thread){
+    StackFrame *sf = reserveFrame(this, variableCount, thread);
+    Something *variables = (Something *)(((Byte *)sf) + sizeof(StackFrame));
+    memset(variables, 0, sizeof(Something) * variableCount);
+    return variables;
 }
 
 void stackPushReservedFrame(Thread *thread){
@@ -44,11 +53,17 @@ void stackPushReservedFrame(Thread *thread){
 }
 
 void stackPush(void *this, uint8_t variableCount, uint8_t argCount, Thread *thread){
-    Something *t = stackReserveFrame(this, variableCount, thread);
+    StackFrame *sf = reserveFrame(this, variableCount, thread);
+    Something *t = (Something *)(((Byte *)sf) + sizeof(StackFrame));
     
+    //The arguments need not be cleared as the GC only sees those that were already evaluated
+    sf->variableCount = 0;
     for (uint8_t i = 0; i < argCount; i++) {
-        t[i] = parse(consumeCoin(thread), thread);
+        t[i] = parse(thread);
+        sf->variableCount = i + 1;
     }
+    memset(t + argCount, 0, sizeof(Something) * (variableCount - argCount));
+    sf->variableCount = variableCount;
     
     stackPushReservedFrame(thread);
 }
@@ -58,16 +73,22 @@ void stackPop(Thread *thread){
     thread->stack = ((StackFrame *)thread->stack)->returnPointer;
 }
 
+Something* stackVariables(Thread *thread){
+    return (Something *)(thread->stack + sizeof(StackFrame));
+}
+
 Something stackGetVariable(uint8_t index, Thread *thread){
     return *(Something *)(thread->stack + sizeof(StackFrame) + sizeof(Something) * index);
 }
 
 void stackDecrementVariable(uint8_t index, Thread *thread){
-    ((Something *)(thread->stack + sizeof(StackFrame) + sizeof(Something) * index))->raw--;
+    Something *v = (Something *)(thread->stack + sizeof(StackFrame) + sizeof(Something) * index);
+    *v = somethingInteger(unwrapInteger(*v) - 1);
 }
 
 void stackIncrementVariable(uint8_t index, Thread *thread){
-    ((Something *)(thread->stack + sizeof(StackFrame) + sizeof(Something) * index))->raw++;
+    Something *v = (Something *)(thread->stack + sizeof(StackFrame) + sizeof(Something) * index);
+    *v = somethingInteger(unwrapInteger(*v) + 1);
 }
 
 void stackSetVariable(uint8_t index, Something value, Thread *thread){
@@ -79,6 +100,10 @@ Object* stackGetThis(Thread *thread){
     return ((StackFrame *)thread->stack)->this;
 }
 
+void failInitializer(Thread *thread){
+    ((StackFrame *)thread->stack)->this = NULL;
+}
+
 Class* stackGetThisClass(Thread *thread){
     return ((StackFrame *)thread->stack)->thisClass;
 }
@@ -0,0 +1,150 @@
+//
+//  Thread.c
+//  Emojicode
+//
+//  Created by agent on 18/10/26.
+//  Copyright © 2026 agent. All rights reserved.
+//
+
+#include "Emojicode.h"
+#include <pthread.h>
+
+/*
+ * Every thread that may access the heap is registered here. A collection stops the world: The collecting thread sets
+ * safepointRequested and waits until every other thread is either stopped at a safepoint or in a blocking region.
+ * Threads in a blocking region must not touch the heap, so they only need to wait for the collection to finish when
+ * they leave the region.
+ */
+
+_Thread_local Thread *currentThread;
+volatile bool safepointRequested = false;
+
+/** Protects the registry and the state of the world, and is used to wait for changes of either. */
+static pthread_mutex_t threadsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t threadsChanged = PTHREAD_COND_INITIALIZER;
+
+static Thread *threads = NULL;
+/** The number of registered threads that are neither stopped at a safepoint nor in a blocking region. */
+static size_t runningThreads = 0;
+/** Whether a thread is collecting or waiting for the others to stop. */
+static bool worldStopped = false;
+
+void threadRegister(Thread *thread){
+    pthread_mutex_lock(&threadsMutex);
+    thread->previousThread = NULL;
+    thread->nextThread = threads;
+    if (threads) {
+        threads->previousThread = thread;
+    }
+    threads = thread;
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+/** Stops the thread until the world is resumed. Must be called with @c threadsMutex held. */
+static void park(){
+    runningThreads--;
+    pthread_cond_broadcast(&threadsChanged);
+    while (worldStopped) {
+        pthread_cond_wait(&threadsChanged, &threadsMutex);
+    }
+    runningThreads++;
+}
+
+void safepoint(Thread *thread){
+    if (thread->safepointsDisabled) {
+        return;
+    }
+    
+    pthread_mutex_lock(&threadsMutex);
+    if (worldStopped) {
+        park();
+    }
+    pthread_mutex_unlock(&threadsMutex);
+    
+    if (collectionRequested) {
+        gc(thread);
+    }
+}
+
+void enterBlockingRegion(Thread *thread){
+    pthread_mutex_lock(&threadsMutex);
+    runningThreads--;
+    pthread_cond_broadcast(&threadsChanged);
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+void leaveBlockingRegion(Thread *thread){
+    pthread_mutex_lock(&threadsMutex);
+    while (worldStopped) {
+        pthread_cond_wait(&threadsChanged, &threadsMutex);
+    }
+    runningThreads++;
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+void threadJoin(Thread *thread, Thread *other){
+    pthread_mutex_lock(&threadsMutex);
+    runningThreads--;
+    pthread_cond_broadcast(&threadsChanged);
+    while (!other->finished || worldStopped) {
+        pthread_cond_wait(&threadsChanged, &threadsMutex);
+    }
+    runningThreads++;
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+void threadFinish(Thread *thread){
+    pthread_mutex_lock(&threadsMutex);
+    if (thread->previousThread) {
+        thread->previousThread->nextThread = thread->nextThread;
+    }
+    else {
+        threads = thread->nextThread;
+    }
+    if (thread->nextThread) {
+        thread->nextThread->previousThread = thread->previousThread;
+    }
+    runningThreads--;
+    thread->finished = true;
+    free(thread->stackLimit);
+    thread->stackLimit = thread->stackBottom = thread->stack = thread->futureStack = NULL;
+    pthread_cond_broadcast(&threadsChanged);
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+bool stopTheWorld(Thread *thread){
+    pthread_mutex_lock(&threadsMutex);
+    if (worldStopped) {
+        park();
+        pthread_mutex_unlock(&threadsMutex);
+        return false;
+    }
+    
+    worldStopped = true;
+    safepointRequested = true;
+    while (runningThreads > 1) {
+        pthread_cond_wait(&threadsChanged, &threadsMutex);
+    }
+    pthread_mutex_unlock(&threadsMutex);
+    return true;
+}
+
+void resumeTheWorld(){
+    pthread_mutex_lock(&threadsMutex);
+    worldStopped = false;
+    safepointRequested = collectionRequested;
+    pthread_cond_broadcast(&threadsChanged);
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+void threadsMarkStacks(){
+    for (Thread *thread = threads; thread; thread = thread->nextThread) {
+        stackMark(thread);
+    }
+}
+
+void threadsResetAllocationBuffers(){
+    for (Thread *thread = threads; thread; thread = thread->nextThread) {
+        thread->allocationPointer = thread->allocationLimit = NULL;
+    }
+}
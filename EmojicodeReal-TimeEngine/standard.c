@@ -9,6 +9,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include "Emojicode.h"
 #include "EmojicodeString.h"
 #include "EmojicodeList.h"
@@ -43,7 +44,7 @@ static Something systemExit(Thread *thread){
 }
 
 static Something systemGetEnv(Thread *thread){
-    char* variableName = stringToChar(stackGetVariable(0, thread).object->value);
+    char* variableName = stringToChar(objectValue(stackGetVariable(0, thread).object));
     char* env = getenv(variableName);
     
     if(!env)
@@ -61,16 +62,47 @@ static Something systemCWD(Thread *thread){
 }
 
 static Something sleepThread(Thread *thread){
-    sleep((unsigned int)stackGetVariable(0, thread).raw);
+    unsigned int seconds = (unsigned int)unwrapInteger(stackGetVariable(0, thread));
+    enterBlockingRegion(thread);
+    sleep(seconds);
+    leaveBlockingRegion(thread);
     return NOTHINGNESS;
 }
 
+static Something systemGCCollections(Thread *thread){
+    return somethingInteger((EmojicodeInteger)(gcStatistics.nurseryCollections + gcStatistics.fullCollections));
+}
+
+static Something systemGCFullCollections(Thread *thread){
+    return somethingInteger((EmojicodeInteger)gcStatistics.fullCollections);
+}
+
+static Something systemGCPauseTime(Thread *thread){
+    return somethingInteger((EmojicodeInteger)(gcStatistics.pauseNanoseconds / 1000));
+}
+
+static Something systemGCBytesCopied(Thread *thread){
+    return somethingInteger((EmojicodeInteger)gcStatistics.bytesCopied);
+}
+
+static Something systemGCBytesScanned(Thread *thread){
+    return somethingInteger((EmojicodeInteger)gcStatistics.bytesScanned);
+}
+
+static Something systemGCObjectsFinalized(Thread *thread){
+    return somethingInteger((EmojicodeInteger)gcStatistics.objectsFinalized);
+}
+
+static Something systemHeapOccupancy(Thread *thread){
+    return somethingInteger((EmojicodeInteger)heapOccupancy());
+}
+
 //MARK: Error
 
 Object* newError(const char *message, int code){
     Object *o = newObject(CL_ERROR);
     
-    EmojicodeError* error = o->value;
+    EmojicodeError* error = objectValue(o);
     error->message = message;
     error->code = code;
     
@@ -78,26 +110,76 @@ Object* newError(const char *message, int code){
 }
 
 void newErrorBridge(Thread *thread){
-    EmojicodeError *error = stackGetThis(thread)->value;
-    error->message = stringToChar(stackGetVariable(0, thread).object->value);
+    EmojicodeError *error = objectValue(stackGetThis(thread));
+    error->message = stringToChar(objectValue(stackGetVariable(0, thread).object));
     error->code = unwrapInteger(stackGetVariable(1, thread));
 }
 
 static Something errorGetMessage(Thread *thread){
-    EmojicodeError *error = stackGetThis(thread)->value;
+    EmojicodeError *error = objectValue(stackGetThis(thread));
     return somethingObject(stringFromChar(error->message));
 }
 
 static Something errorGetCode(Thread *thread){
-    EmojicodeError *error = stackGetThis(thread)->value;
+    EmojicodeError *error = objectValue(stackGetThis(thread));
     return somethingInteger((EmojicodeInteger)error->code);
 }
 
+//MARK: Threads
+
+/** Runs the callable in the first stack frame of the thread and stores its result in the 🧵, which is this. */
+static void* threadMain(void *argument){
+    Thread *thread = currentThread = argument;
+    leaveBlockingRegion(thread);
+    
+    Something result = executeCallableExtern(stackGetVariable(0, thread).object, NULL, thread);
+    
+    Object *threadObject = stackGetThis(thread);
+    ((EmojicodeThread *)objectValue(threadObject))->result = result;
+    writeBarrier(threadObject, result);
+    
+    threadFinish(thread);
+    return NULL;
+}
+
+static void threadInitBridge(Thread *thread){
+    Thread *spawned = allocateThread();
+    
+    //The callable and the 🧵 are kept alive by the frame as long as the thread runs
+    Something *variables = stackReserveFrame(stackGetThis(thread), 1, spawned);
+    variables[0] = stackGetVariable(0, thread);
+    stackPushReservedFrame(spawned);
+    ((EmojicodeThread *)objectValue(stackGetThis(thread)))->thread = spawned;
+    
+    pthread_t osThread;
+    if (pthread_create(&osThread, NULL, threadMain, spawned) != 0) {
+        error("Could not start thread.");
+    }
+    pthread_detach(osThread);
+}
+
+static Something threadJoinBridge(Thread *thread){
+    threadJoin(thread, ((EmojicodeThread *)objectValue(stackGetThis(thread)))->thread);
+    return ((EmojicodeThread *)objectValue(stackGetThis(thread)))->result;
+}
+
+static void threadMark(Object *o){
+    EmojicodeThread *t = objectValue(o);
+    if (isRealObject(t->result)) {
+        mark(&t->result.object);
+    }
+}
+
+/** A 🧵 can only become garbage once its thread finished, as the thread’s stack references it until then. */
+static void threadDeinit(void *value){
+    free(((EmojicodeThread *)value)->thread);
+}
+
 //MARK: Data
 
 static Something dataEqual(Thread *thread){
-    Data *d = stackGetThis(thread)->value;
-    Data *b = stackGetVariable(0, thread).object->value;
+    Data *d = objectValue(stackGetThis(thread));
+    Data *b = objectValue(stackGetVariable(0, thread).object);
     
     if(d->length != b->length){
         return EMOJICODE_FALSE;
@@ -112,20 +194,29 @@ static Something dataEqual(Thread *thread){
 }
 
 static Something dataSize(Thread *thread){
-    Data *d = stackGetThis(thread)->value;
+    Data *d = objectValue(stackGetThis(thread));
     return somethingInteger((EmojicodeInteger)d->length);
 }
 
+/** The bytes of every 📇 are allocated with malloc and owned by it. */
+static void dataDeinit(void *value){
+    free(((Data *)value)->bytes);
+}
+
 static void closureMark(Object *o){
-    Closure *c = o->value;
+    Closure *c = objectValue(o);
     if (isPossibleObjectPointer(c->this)) {
         mark((Object **)&c->this);
     }
+    //The closure is marked while its captured variables are allocated
+    if (!c->capturedVariables) {
+        return;
+    }
     mark(&c->capturedVariables);
     
-    Something *t = c->capturedVariables->value;
+    Something *t = objectValue(c->capturedVariables);
     for (uint8_t i = 0; i < c->capturedVariablesCount; i++) {
-        Something *s = t + c->argumentCount + i;
+        Something *s = t + i;
         if (isRealObject(*s)) {
             mark(&s->object);
         }
@@ -133,7 +224,7 @@ static void closureMark(Object *o){
 }
 
 static void capturedMethodMark(Object *o){
-    CapturedMethodCall *c = o->value;
+    CapturedMethodCall *c = objectValue(o);
     mark(&c->object);
 }
 
@@ -162,6 +253,17 @@ MethodHandler handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar symbol) {
             }
         case 0x1F36F:
             return dictionaryMethodForName(symbol);
+        case 0x1F3AB: //🎫
+        case 0x1F4A0: //💠
+            return dictionaryEnumeratorMethodForName(cl, symbol);
+        case 0x1F9F5: //🧵
+            switch (symbol) {
+                case 0x1F91D: //🤝
+                    return threadJoinBridge;
+            }
+            break;
+        case 0x1F9F1: //🧱
+            return stringBuilderMethodForName(symbol);
     }
     return NULL;
 }
@@ -178,6 +280,10 @@ InitializerHandler handlerPointerForInitializer(EmojicodeChar cl, EmojicodeChar
             return newErrorBridge;
         case 0x1F36F: //Only dictionary contstructor 0x1F438
             return bridgeDictionaryInit;
+        case 0x1F9F5: //🧵’s only initializer 0x1F195
+            return threadInitBridge;
+        case 0x1F9F1: //🧱
+            return stringBuilderInitializerForName(symbol);
     }
     return NULL;
 }
@@ -192,6 +298,20 @@ ClassMethodHandler handlerPointerForClassMethod(EmojicodeChar cl, EmojicodeChar
             return systemCWD;
         case 0x1F570:
             return sleepThread;
+        case 0x1F5D1: //🗑
+            return systemGCCollections;
+        case 0x1F69B: //🚛
+            return systemGCFullCollections;
+        case 0x1F553: //🕓
+            return systemGCPauseTime;
+        case 0x1F4E6: //📦
+            return systemGCBytesCopied;
+        case 0x1F50D: //🔍
+            return systemGCBytesScanned;
+        case 0x1F480: //💀
+            return systemGCObjectsFinalized;
+        case 0x1F4CA: //📊
+            return systemHeapOccupancy;
     }
     return NULL;
 }
@@ -204,12 +324,19 @@ uint_fast32_t sizeForClass(Class *cl, EmojicodeChar name) {
             return sizeof(List);
         case 0x1F36F:
             return sizeof(EmojicodeDictionary);
+        case 0x1F3AB:
+        case 0x1F4A0:
+            return sizeof(EmojicodeDictionaryEnumerator);
         case 0x1F4C7:
             return sizeof(Data);
         case 0x1F347:
             return sizeof(Closure);
         case 0x1F336:
             return sizeof(CapturedMethodCall);
+        case 0x1F9F5:
+            return sizeof(EmojicodeThread);
+        case 0x1F9F1:
+            return sizeof(StringBuilder);
     }
     return 0;
 }
@@ -220,20 +347,29 @@ Marker markerPointerForClass(EmojicodeChar cl){
             return listMark;
         case 0x1F36F: //Dictionary
             return dictionaryMark;
+        case 0x1F3AB: //Dictionary entry enumerator
+        case 0x1F4A0: //Dictionary value enumerator
+            return dictionaryEnumeratorMark;
         case 0x1F521:
             return stringMark;
         case 0x1F347:
             return closureMark;
         case 0x1F336:
             return capturedMethodMark;
+        case 0x1F9F5:
+            return threadMark;
+        case 0x1F9F1:
+            return stringBuilderMark;
     }
     return NULL;
 }
 
 Deinitializer deinitializerPointerForClass(EmojicodeChar cl){
     switch (cl) {
-//        case 0x1F4C7:
-//            return releaseData;
+        case 0x1F4C7:
+            return dataDeinit;
+        case 0x1F9F5:
+            return threadDeinit;
     }
     return NULL;
 }
@@ -29,6 +29,13 @@
 #endif
 #include <assert.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "utf8.h"
 
 static const uint32_t offsetsFromUTF8[6] = {
@@ -70,13 +77,130 @@ size_t u8_charlen(uint32_t ch)
 
 size_t u8_codingsize(const uint32_t *wcstr, size_t n)
 {
-    size_t i, c=0;
-
-    for(i=0; i < n; i++)
+    size_t i = 0, c = 0;
+
+#if defined(__SSE2__)
+    /* every character below U+110000 takes one byte plus one for each of
+       the thresholds it exceeds. the comparisons yield -1 for every
+       threshold exceeded, which is subtracted from the lanes of extra.
+       blocks with larger characters are left to u8_charlen */
+    __m128i t1 = _mm_set1_epi32(0x7F), t2 = _mm_set1_epi32(0x7FF);
+    __m128i t3 = _mm_set1_epi32(0xFFFF), max = _mm_set1_epi32(0x10FFFF), zero = _mm_setzero_si128();
+    while (i + 4 <= n) {
+        __m128i extra = _mm_setzero_si128();
+        size_t blockEnd = i + 4 * 0x10000 < n ? i + 4 * 0x10000 : n;
+        for (; i + 4 <= blockEnd; i += 4) {
+            __m128i ch = _mm_loadu_si128((const __m128i *)(wcstr + i));
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpgt_epi32(ch, max), _mm_cmplt_epi32(ch, zero))))
+                break;
+            extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(ch, t1));
+            extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(ch, t2));
+            extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(ch, t3));
+            c += 4;
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, extra);
+        c += (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        if (i + 4 <= blockEnd)
+            break;
+    }
+#endif
+    for(; i < n; i++)
         c += u8_charlen(wcstr[i]);
     return c;
 }
 
+/* returns the # of leading ASCII bytes among the first n bytes of s */
+static size_t ascii_prefix(const unsigned char *s, size_t n)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32) {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(s + i)));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(s + i)));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < n && s[i] < 0x80)
+        i++;
+    return i;
+}
+
+/* zero extends n bytes to wide characters */
+static void widen_bytes(uint32_t *dest, const unsigned char *src, size_t n)
+{
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero), hi = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_si128((__m128i *)(dest + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i *)(dest + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+#endif
+    for (; i < n; i++)
+        dest[i] = src[i];
+}
+
+/* validates UTF-8 data and counts its characters in the same pass. the
+   data must not contain overlong sequences or sequences longer than 4
+   bytes. *latin1 is set to nonzero if all characters are at most U+00FF,
+   i.e. if u8_tolatin1 can convert the data.
+   returns 0 if the data is not valid */
+int u8_validate(const char *src, size_t srcsz, size_t *charnum, int *latin1)
+{
+    const unsigned char *s = (const unsigned char *)src;
+    size_t i = 0, count = 0;
+    int onlylatin1 = 1;
+
+    while (i < srcsz) {
+        size_t run = ascii_prefix(s + i, srcsz - i);
+        i += run;
+        count += run;
+        if (i >= srcsz)
+            break;
+
+        unsigned char c = s[i];
+        size_t nb;
+        if (c >= 0xC2 && c <= 0xDF)
+            nb = 1;
+        else if (c >= 0xE0 && c <= 0xEF)
+            nb = 2;
+        else if (c >= 0xF0 && c <= 0xF4)
+            nb = 3;
+        else
+            return 0;
+        if (srcsz - i <= nb)
+            return 0;
+        for (size_t j = 1; j <= nb; j++) {
+            if ((s[i + j] & 0xC0) != 0x80)
+                return 0;
+        }
+        /* overlong and out of range sequences */
+        if ((c == 0xE0 && s[i + 1] < 0xA0) || (c == 0xF0 && s[i + 1] < 0x90) || (c == 0xF4 && s[i + 1] > 0x8F))
+            return 0;
+        if (c > 0xC3)
+            onlylatin1 = 0;
+        i += nb + 1;
+        count++;
+    }
+    *charnum = count;
+    *latin1 = onlylatin1;
+    return 1;
+}
+
 /* conversions without error checking
    only works for valid UTF-8, i.e. no 5- or 6-byte sequences
    srcsz = source size in bytes
@@ -96,6 +220,12 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz)
         return 0;
 
     while (i < sz) {
+        size_t run = ascii_prefix((const unsigned char *)src, sz - i < (size_t)(src_end - src) ? sz - i : (size_t)(src_end - src));
+        widen_bytes(dest + i, (const unsigned char *)src, run);
+        i += run;
+        src += run;
+        if (i >= sz || src >= src_end)
+            break;
         if (!isutf(*src)) {     // invalid sequence
             dest[i++] = 0xFFFD;
             src++;
@@ -121,6 +251,80 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz)
     return i;
 }
 
+/* converts valid UTF-8 data only containing characters up to U+00FF to
+   one byte per character
+   sz = size of dest buffer in bytes
+   returns # characters converted */
+size_t u8_tolatin1(uint8_t *dest, size_t sz, const char *src, size_t srcsz)
+{
+    const char *src_end = src + srcsz;
+    size_t i = 0;
+
+    while (i < sz && src < src_end) {
+        size_t run = ascii_prefix((const unsigned char *)src, sz - i < (size_t)(src_end - src) ? sz - i : (size_t)(src_end - src));
+        memcpy(dest + i, src, run);
+        i += run;
+        src += run;
+        if (i >= sz || src >= src_end)
+            break;
+        unsigned char c = (unsigned char)*src++;
+        if (c < 0x80) {
+            dest[i++] = c;
+        }
+        else {
+            dest[i++] = (uint8_t)(((c & 0x1F) << 6) | ((unsigned char)*src++ & 0x3F));
+        }
+    }
+    return i;
+}
+
+/* computes the # of bytes needed to encode a Latin-1 string as UTF-8 */
+size_t u8_latin1codingsize(const uint8_t *src, size_t n)
+{
+    size_t i = 0, c = n;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16)
+        c += __builtin_popcount((uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(src + i))));
+#endif
+    for (; i < n; i++)
+        c += src[i] >> 7;
+    return c;
+}
+
+/* the opposite conversion of u8_tolatin1
+   srcsz = number of source characters
+   sz = size of dest buffer in bytes
+   returns # bytes stored in dest */
+size_t u8_fromlatin1(char *dest, size_t sz, const uint8_t *src, size_t srcsz)
+{
+    char *dest0 = dest;
+    char *dest_end = dest + sz;
+    size_t i;
+
+    for (i = 0; i < srcsz; i++) {
+        size_t run = ascii_prefix(src + i, srcsz - i < (size_t)(dest_end - dest) ? srcsz - i : (size_t)(dest_end - dest));
+        memcpy(dest, src + i, run);
+        dest += run;
+        i += run;
+        if (i >= srcsz)
+            break;
+        uint8_t ch = src[i];
+        if (ch < 0x80) {
+            if (dest >= dest_end)
+                break;
+            *dest++ = (char)ch;
+        }
+        else {
+            if (dest >= dest_end - 1)
+                break;
+            *dest++ = (char)(0xC0 | (ch >> 6));
+            *dest++ = (char)(0x80 | (ch & 0x3F));
+        }
+    }
+    return dest - dest0;
+}
+
 /* srcsz = number of source characters
    sz = size of dest buffer in bytes
 
@@ -135,6 +339,23 @@ size_t u8_toutf8(char *dest, size_t sz, const uint32_t *src, size_t srcsz)
     char *dest_end = dest + sz;
 
     while (i < srcsz) {
+#if defined(__SSE2__)
+        /* narrows 16 ASCII characters at once */
+        while (i + 16 <= srcsz && dest_end - dest >= 16) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 4));
+            __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 8));
+            __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 12));
+            __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, _mm_set1_epi32(~0x7F)), _mm_setzero_si128())) != 0xFFFF)
+                break;
+            _mm_storeu_si128((__m128i *)dest, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+            dest += 16;
+            i += 16;
+        }
+        if (i >= srcsz)
+            break;
+#endif
         ch = src[i];
         if (ch < 0x80) {
             if (dest >= dest_end)
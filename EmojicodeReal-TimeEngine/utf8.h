@@ -22,6 +22,19 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz);
 /* the opposite conversion */
 size_t u8_toutf8(char *dest, size_t sz, const uint32_t *src, size_t srcsz);
 
+/* validate UTF-8 data and count its characters in a single pass, also
+   determining whether it only contains characters up to U+00FF */
+int u8_validate(const char *src, size_t srcsz, size_t *charnum, int *latin1);
+
+/* convert valid UTF-8 data only containing characters up to U+00FF to Latin-1 */
+size_t u8_tolatin1(uint8_t *dest, size_t sz, const char *src, size_t srcsz);
+
+/* the opposite conversion */
+size_t u8_fromlatin1(char *dest, size_t sz, const uint8_t *src, size_t srcsz);
+
+/* computes the # of bytes needed to encode a Latin-1 string as UTF-8 */
+size_t u8_latin1codingsize(const uint8_t *src, size_t n);
+
 /* single character to UTF-8, returns # bytes written */
 size_t u8_wc_toutf8(char *dest, uint32_t ch);
 
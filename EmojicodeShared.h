@@ -25,7 +25,22 @@ typedef uint32_t EmojicodeCoin;
 
 /* Using either of them in a package makes absolutely no sense */
 #define packageDirectory "/usr/local/EmojicodePackages/"
-#define ByteCodeSpecificationVersion 3
+#define ByteCodeSpecificationVersion 5
+
+/**
+ * How a list stores its elements. The compiler selects the storage from the element type of the list, lists of
+ * integers, doubles and symbols store their elements unboxed.
+ */
+typedef enum {
+    /** Every element is a Something. */
+    LIST_STORAGE_SOMETHING = 0,
+    /** Every element is an EmojicodeInteger. */
+    LIST_STORAGE_INTEGER = 1,
+    /** Every element is a double. */
+    LIST_STORAGE_DOUBLE = 2,
+    /** Every element is an EmojicodeChar. */
+    LIST_STORAGE_SYMBOL = 3
+} ListStorage;
 
 /** The version of a package. Must follow semantic versioning 2.0 http://semver.org */
 typedef struct {
@@ -14,20 +14,110 @@
 
 extern Object **stringPool;
 #define emptyString (stringPool[0])
-#define characters(string) ((EmojicodeChar*)(string)->characters->value)
+
+/** Whether a string containing the code point @c c can be stored compactly. */
+#define characterFitsCompact(c) ((c) <= 0xFF)
+/** The size of the characters object of a string with @c length code points. */
+#define stringStorageSize(length, compact) ((size_t)(length) * ((compact) ? 1 : sizeof(EmojicodeChar)))
+/** The first code point of a string in its characters object. */
+#define stringStorage(string) ((Byte *)objectValue((string)->characters) + stringStorageSize((string)->offset, (string)->compact))
+/** The code points of a compact string. */
+#define compactCharacters(string) ((uint8_t *)stringStorage(string))
+/** The code points of a string that is not compact. */
+#define wideCharacters(string) ((EmojicodeChar *)stringStorage(string))
+
+/**
+ * 🔪 and 🔧 return substrings that share the characters object of their string unless the characters object can hold
+ * more than this many times the code points of the substring. The code points are copied in that case so that a small
+ * substring does not keep a huge string alive.
+ */
+#ifndef substringViewRatio
+#define substringViewRatio 4
+#endif
+
+/** Returns the code point at @c index, which must be less than the string’s length. */
+static inline EmojicodeChar stringCharacterAt(String *string, EmojicodeInteger index){
+    return string->compact ? compactCharacters(string)[index] : wideCharacters(string)[index];
+}
+
+/**
+ * Returns a copy of all code points of the string as UTF-32, regardless of how the string is stored. This replaces the
+ * former @c characters macro for packages that accessed the characters object directly. Writing to the copy does not
+ * change the string. Use @c stringCharacterAt to access single code points.
+ * @warning Do not forget to free the array.
+ */
+EmojicodeChar* stringUTF32(String *string);
+
+/**
+ * Copies the code points of @c from to @c to starting at @c offset. @c to must not be compact unless @c from is
+ * compact.
+ */
+void stringCopyCharacters(String *to, size_t offset, String *from);
+
+/**
+ * Returns a string with @c length code points of @c stro starting at @c from. The range is clamped to the string.
+ * Whether the substring shares the characters of @c stro is determined by @c substringViewRatio.
+ * @warning GC-invoking
+ */
+Object* stringSubstring(Object *stro, EmojicodeInteger from, EmojicodeInteger length, Thread *thread);
 
 /** Comparse if the value of a is equal to b */
 bool stringEqual(String *a, String *b);
 
+/** Compares the strings lexicographically by their code points. Returns a negative value if a is ordered before b, a positive value if a is ordered after b, and 0 if they are equal. */
+int stringCompare(String *a, String *b);
+
+/** Returns the hash of the string. The hash is calculated on first use and cached in the string. */
+uint64_t stringHash(String *string);
+
 /** Converts the string to a UTF8 char array. @warning Do not forget to free the char array. */
 char* stringToChar(String *str);
 
+/**
+ * Like @c stringToChar but also stores the number of bytes, not including the null terminator, in @c length unless it
+ * is @c NULL.
+ * @warning Do not forget to free the char array.
+ */
+char* stringToUTF8(String *str, size_t *length);
+
 /** Creates a string from a UTF8 C string. The string must be null terminated! */
 Object* stringFromChar(const char *cstring);
 
+/**
+ * Creates a string from @c length bytes of UTF8, which do not need to be null terminated. Invalid sequences are
+ * replaced with U+FFFD.
+ * @warning GC-invoking
+ */
+Object* stringFromUTF8(const char *bytes, size_t length);
+
+/**
+ * Stores the code points encoded by the UTF8 bytes in @c string. @c bytes must not point into an object.
+ * @warning GC-invoking
+ */
+void initStringFromUTF8(Object *string, const char *bytes, size_t length, Thread *thread);
+
 void stringMark(Object *self);
 
-void initStringFromSymbolList(Object *string, List *list);
+/** The value of a 🧱 instance, a string to which code points are appended in amortized O(1). */
+typedef struct {
+    /** The number of code points appended so far. */
+    EmojicodeInteger length;
+    /** The number of code points @c characters can hold. */
+    EmojicodeInteger capacity;
+    /** The code points, stored like the characters of a string with the same @c compact value. */
+    Object *characters;
+    /** Whether @c characters stores one byte per code point. */
+    bool compact;
+    /** Whether a string returned by 🔡 shares @c characters, which must be copied before they are changed. */
+    bool shared;
+} StringBuilder;
+
+void stringBuilderMark(Object *self);
+MethodHandler stringBuilderMethodForName(EmojicodeChar name);
+InitializerHandler stringBuilderInitializerForName(EmojicodeChar name);
+
+/** @warning GC-invoking */
+void initStringFromSymbolList(Object *string, Object *list, Thread *thread);
 
 MethodHandler stringMethodForName(EmojicodeChar name);
 InitializerHandler stringInitializerForName(EmojicodeChar name);